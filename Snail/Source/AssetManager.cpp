@@ -8,6 +8,7 @@ namespace Snail
 
 	void AssetManager::init()
 	{
+		isExclusive = false; // update does nothing
 		loadShaders();
 	}
 
@@ -0,0 +1,77 @@
+#include "CommandBuffer.h"
+#include "EntityManager.h"
+#include "Core.h"
+
+#include <algorithm>
+
+namespace Snail
+{
+
+	void CommandBuffer::init()
+	{
+		isExclusive = false; // update does nothing
+	}
+
+	void CommandBuffer::update()
+	{
+
+	}
+
+	void CommandBuffer::free()
+	{
+
+	}
+
+	void CommandBuffer::addEntity(std::function<void(EntityId)> onAdded)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		toAdd.push_back(std::move(onAdded));
+	}
+
+	void CommandBuffer::removeEntity(EntityId id)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		toRemove.push_back(id);
+	}
+
+	void CommandBuffer::flush()
+	{
+		std::vector<std::function<void(EntityId)>> currAdd;
+		std::vector<EntityId> currRemove;
+		std::vector<std::pair<EntityId, std::function<void()>>> currCompChanges;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			currAdd.swap(toAdd);
+			currRemove.swap(toRemove);
+			currCompChanges.swap(compChanges);
+		}
+
+		if (currAdd.empty() && currRemove.empty() && currCompChanges.empty())
+			return;
+
+		// an entity may be removed more than once in a frame, and may already be gone
+		std::sort(currRemove.begin(), currRemove.end());
+		currRemove.erase(std::unique(currRemove.begin(), currRemove.end()), currRemove.end());
+		currRemove.erase(std::remove_if(currRemove.begin(), currRemove.end(),
+			[](EntityId id) { return !gs(EntityManager)->isEntityAlive(id); }), currRemove.end());
+
+		// component changes to entities that are about to be removed are dropped
+		for (auto &[id, change] : currCompChanges)
+			if (!std::binary_search(currRemove.begin(), currRemove.end(), id) && 
+				gs(EntityManager)->isEntityAlive(id))
+				change();
+
+		if (currRemove.size())
+			gs(EntityManager)->removeEntities(currRemove);
+
+		if (currAdd.size())
+		{
+			std::vector<EntityId> newIds = gs(EntityManager)->addEntities(static_cast<unsigned>(currAdd.size()));
+			for (size_t i = 0; i < newIds.size(); ++i)
+				if (currAdd[i])
+					currAdd[i](newIds[i]);
+		}
+	}
+
+}
\ No newline at end of file
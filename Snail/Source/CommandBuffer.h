@@ -0,0 +1,51 @@
+#pragma once
+
+#include "System.h"
+#include "Utility.h"
+#include "Types.h"
+#include "ComponentManager.h"
+
+#include <functional>
+#include <mutex>
+
+namespace Snail
+{
+
+	// structural changes (adding or removing entities and components) recorded while systems are running
+	// and applied together in flush, which Core calls between systems, so views are never modified while
+	// being iterated through (recording is thread safe so systems running in parallel can share it)
+	class CommandBuffer : public System
+	{
+		std::mutex mutex;
+		std::vector<std::function<void(EntityId)>> toAdd; // called with the new entity's id once it exists
+		std::vector<EntityId> toRemove;
+		std::vector<std::pair<EntityId, std::function<void()>>> compChanges; // in the order they were recorded
+
+	public:
+
+		void init() override;
+		void update() override;
+		void free() override;
+
+		void addEntity(std::function<void(EntityId)> onAdded = nullptr);
+		void removeEntity(EntityId id);
+
+		template <typename T>
+		void addComponent(EntityId id, T component = T())
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			compChanges.emplace_back(id, [id, component]() {
+				gs(ComponentManager)->addComponent<T>(id, component); });
+		}
+
+		template <typename T>
+		void removeComponent(EntityId id)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			compChanges.emplace_back(id, [id]() { gs(ComponentManager)->removeComponent<T>(id); });
+		}
+
+		void flush(); // must not be called while any system is running
+	};
+
+}
\ No newline at end of file
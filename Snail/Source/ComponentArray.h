@@ -1,9 +1,9 @@
 #pragma once
 
 #include "EntityManager.h"
+#include "PagedArray.h"
 
-#include <array>
-#include <unordered_map>
+#include <vector>
 
 namespace Snail
 {
@@ -20,52 +20,85 @@ namespace Snail
 	template <typename T>
 	class ComponentArray : public ComponentArrayBase
 	{
-		std::array<T, MAX_ENTITIES> allData;
-		std::unordered_map<size_t, EntityId> indexToEntityId;
-		std::unordered_map<EntityId, size_t> entityIdToIndex;
-
-		size_t size = 0; // size of valid entries in component data array
+		// sparse set: allData and dense are packed and share indices, sparse maps entity index to that index
+		// allData and dense only grow with the number of components actually added
+		std::vector<T> allData;
+		std::vector<EntityId> dense; // owner of each entry in allData
+		PagedArray<size_t> sparse; // only valid if dense points back to the same entity id
 
 	public:
 
 		void addData(EntityId id, T data)
 		{
-			crashIf(id >= MAX_ENTITIES, "Entity with id " + toStr(id) + " is out of bounds");
-			crashIf(size >= MAX_ENTITIES, Util::quote(typeid(T).name()) + " component array is full");
+			crashIf(getEntityIndex(id) >= MAX_ENTITIES, "Entity with id " + toStr(id) + " is out of bounds");
+			crashIf(hasData(id), "Entity " + toStr(id) + " already has " + Util::quote(typeid(T).name()) +
+				" component");
 
-			indexToEntityId[size] = id;
-			entityIdToIndex[id] = size;
-			allData[size++] = data;
+			sparse[getEntityIndex(id)] = dense.size();
+			dense.push_back(id);
+			allData.push_back(std::move(data));
 		}
 
 		void removeData(EntityId id)
 		{
-			crashIf(!entityIdToIndex.count(id), "Entity " + toStr(id) + " does not have " + 
+			crashIf(!hasData(id), "Entity " + toStr(id) + " does not have " + 
 				Util::quote(typeid(T).name()) + " component");
-			crashIf(!indexToEntityId.count(size), "Last index of " + Util::quote(typeid(T).name()) +
-				" component array does not have corresponding entity");
-
-			allData[entityIdToIndex.at(id)] = allData[--size]; // copy last element to deleted element
-			entityIdToIndex.at(indexToEntityId.at(size)) = entityIdToIndex.at(id); // update last element's mapping
-			indexToEntityId.at(entityIdToIndex.at(id)) = indexToEntityId.at(size); // update last element's mapping
-			entityIdToIndex.erase(id); // delete deleted element's mapping
-			indexToEntityId.erase(entityIdToIndex.at(id)); // delete deleted element's mapping
+
+			// swap and pop so the arrays stay packed
+			size_t removed = sparse[getEntityIndex(id)];
+			EntityId last = dense.back();
+			if (removed != dense.size() - 1)
+			{
+				allData[removed] = std::move(allData.back());
+				dense[removed] = last;
+				sparse[getEntityIndex(last)] = removed;
+			}
+			allData.pop_back();
+			dense.pop_back();
 		}
 
 		T &getData(EntityId id)
 		{
-			crashIf(!entityIdToIndex.count(id), "Entity " + toStr(id) + " does not have " +
+			crashIf(!hasData(id), "Entity " + toStr(id) + " does not have " +
 				Util::quote(typeid(T).name()) + " component");
 
-			return allData[entityIdToIndex.at(id)];
+			return allData[sparse[getEntityIndex(id)]];
+		}
+
+		bool hasData(EntityId id) const
+		{
+			const size_t *index = sparse.find(getEntityIndex(id));
+			return index && *index < dense.size() && dense[*index] == id;
+		}
+
+		void reserve(size_t count)
+		{
+			allData.reserve(count);
+			dense.reserve(count);
 		}
 
 		void removeDataIfPresent(EntityId id) override
 		{
-			if (entityIdToIndex.count(id))
+			if (hasData(id))
 				removeData(id);
 		}
 
+		// for iterating over every component of this type, getAllData()[i] belongs to getEntityIds()[i]
+		size_t getSize() const
+		{
+			return dense.size();
+		}
+
+		T *getAllData()
+		{
+			return allData.data();
+		}
+
+		const EntityId *getEntityIds() const
+		{
+			return dense.data();
+		}
+
 	};
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@ namespace Snail
 
 	void ComponentManager::init()
 	{
+		isExclusive = false; // update does nothing
 		registerComponent<TransformComponent>();
 		registerComponent<ShapeComponent>();
 	}
@@ -25,6 +26,11 @@ namespace Snail
 		return compNames[compId];
 	}
 
+	CompId ComponentManager::getCompCount()
+	{
+		return nextCompId;
+	}
+
 	CompId ComponentManager::getCompId(const std::string &compName)
 	{
 		crashIf(!compIds.count(compName), "Invalid compName " + Util::quote(compName));
@@ -33,8 +39,9 @@ namespace Snail
 
 	void ComponentManager::signalEntityRemoved(EntityId id)
 	{
-		for (const auto &[compName, compArray] : compArrays)
-			compArray->removeDataIfPresent(id);
+		// only the arrays this entity actually has components in
+		gs(EntityManager)->getSignature(id).forEach([this, id](CompId compId) {
+			compArrays[compId]->removeDataIfPresent(id); });
 	}
 
 }
\ No newline at end of file
@@ -2,9 +2,12 @@
 
 #include "EntityManager.h"
 #include "ComponentArray.h"
+#include "View.h"
+#include "JobSystem.h"
 #include "Core.h"
 
 #include <unordered_map>
+#include <optional>
 
 namespace Snail
 {
@@ -13,10 +16,30 @@ namespace Snail
 	{
 		CompId nextCompId = 0;
 
-		std::unordered_map<std::string, std::unique_ptr<ComponentArrayBase>> compArrays;
-		std::unordered_map<std::string, CompId> compIds; // name to id
+		std::vector<std::unique_ptr<ComponentArrayBase>> compArrays; // indexed by id
+		std::unordered_map<std::string, CompId> compIds; // name to id (only for editor and serialisation)
 		std::vector<std::string> compNames; // id to name (in order)
 
+		// id is assigned once on registration so lookups never have to touch the type's name
+		template <typename T>
+		struct CompIdOf
+		{
+			static inline CompId value = INVALID_COMP_ID;
+		};
+
+		// query index into EntityManager for each combination of components that has been viewed
+		template <typename... Ts>
+		struct QueryOf
+		{
+			static inline std::optional<size_t> value = std::nullopt;
+		};
+
+		template <typename T>
+		ComponentArray<T> *getCompArray()
+		{
+			return static_cast<ComponentArray<T> *>(compArrays[getCompId<T>()].get());
+		}
+
 	public:
 
 		void init() override;
@@ -29,10 +52,13 @@ namespace Snail
 			std::string compName = typeid(T).name();
 			Util::trimString(compName, "struct Snail::");
 			Util::trimString(compName, "Component", false);
-			crashIf(compArrays.count(compName), "Component " + Util::quote(compName) + 
+			crashIf(CompIdOf<T>::value != INVALID_COMP_ID, "Component " + Util::quote(compName) + 
 				" was added more than once");
+			crashIf(nextCompId >= MAX_COMPONENTS, "Cannot register " + Util::quote(compName) + 
+				", raise MAX_COMPONENTS to have more than " + toStr(MAX_COMPONENTS) + " components");
 
-			compArrays[compName] = std::make_unique<ComponentArray<T>>();
+			CompIdOf<T>::value = nextCompId;
+			compArrays.push_back(std::make_unique<ComponentArray<T>>());
 			compIds[compName] = nextCompId++;
 			compNames.push_back(compName);
 		}
@@ -40,59 +66,97 @@ namespace Snail
 		template <typename T>
 		CompId getCompId()
 		{
-			std::string compName = typeid(T).name();
-			Util::trimString(compName, "struct Snail::");
-			Util::trimString(compName, "Component", false);
-			crashIf(!compIds.count(compName), "Component " + Util::quote(compName) + " was not registered");
-
-			return compIds.at(compName);
+			crashIf(CompIdOf<T>::value == INVALID_COMP_ID, "Component " + Util::quote(typeid(T).name()) + 
+				" was not registered");
+			return CompIdOf<T>::value;
 		}
 
 		template <typename T>
 		void addComponent(EntityId id, T component = T())
 		{
-			std::string compName = typeid(T).name();
-			Util::trimString(compName, "struct Snail::");
-			Util::trimString(compName, "Component", false);
-			crashIf(!compIds.count(compName), "Component " + Util::quote(compName) + " was not registered");
-			 
-			dynamic_cast<ComponentArray<T> *>(compArrays.at(compName).get())->addData(id, component);
+			getCompArray<T>()->addData(id, component);
 
-			Signature newSig;
-			gs(EntityManager)->setSignature(id, newSig.set(getCompId<T>()) | 
-				gs(EntityManager)->getSignature(id));
+			gs(EntityManager)->setSignature(id, gs(EntityManager)->getSignature(id).set(getCompId<T>()));
 		}
 
 		template <typename T>
 		void removeComponent(EntityId id)
 		{
-			std::string compName = typeid(T).name();
-			Util::trimString(compName, "struct Snail::");
-			Util::trimString(compName, "Component", false);
-			crashIf(!compIds.count(compName), "Component " + Util::quote(compName) + " was not registered");
-
-			dynamic_cast<ComponentArray<T> *>(compArrays.at(compName).get())->removeData(id);
+			getCompArray<T>()->removeData(id);
 			
-			Signature newSig;
-			gs(EntityManager)->setSignature(id, newSig.set().reset(getCompId<T>()) &
-				gs(EntityManager)->getSignature(id));
+			gs(EntityManager)->setSignature(id, gs(EntityManager)->getSignature(id).reset(getCompId<T>()));
+		}
+
+		// spawns count entities that each get a copy of every prototype, in one pass per component type
+		template <typename... Ts>
+		std::vector<EntityId> addEntities(unsigned count, const Ts &...prototypes)
+		{
+			Signature signature;
+			(signature.set(getCompId<Ts>()), ...);
+			std::vector<EntityId> ids = gs(EntityManager)->addEntities(count, signature);
+
+			([&](ComponentArray<Ts> *compArray, const Ts &prototype) {
+				for (EntityId id : ids)
+					compArray->addData(id, prototype);
+			}(getCompArray<Ts>(), prototypes), ...);
+
+			return ids;
+		}
+
+		template <typename T>
+		void reserveComponents(size_t count)
+		{
+			getCompArray<T>()->reserve(count);
 		}
 
 		template <typename T>
 		T &getComponent(EntityId id)
 		{
-			std::string compName = typeid(T).name();
-			Util::trimString(compName, "struct Snail::");
-			Util::trimString(compName, "Component", false);
-			crashIf(!compIds.count(compName), "Component " + Util::quote(compName) + " was not registered");
+			return getCompArray<T>()->getData(id);
+		}
+
+		template <typename... Ts>
+		View<Ts...> getView()
+		{
+			static_assert(sizeof...(Ts), "A view needs at least one component");
+
+			if (!QueryOf<Ts...>::value)
+			{
+				Signature signature;
+				(signature.set(getCompId<Ts>()), ...);
+				QueryOf<Ts...>::value = gs(EntityManager)->addQuery(signature);
+			}
+
+			return View<Ts...>(gs(EntityManager)->getQueryEntityIds(*QueryOf<Ts...>::value), 
+				getCompArray<Ts>()...);
+		}
+
+		// same as getView<Ts...>().each(func) but split into chunks that run on every core, returns once all
+		// are done so func must only touch its own entity's components and record structural changes in the
+		// command buffer
+		template <typename... Ts, typename Func>
+		void parallelForEach(Func func, size_t chunkSize = MEDIUM)
+		{
+			crashIf(!chunkSize, "Chunks must hold at least 1 entity");
+
+			View<Ts...> view = getView<Ts...>();
+			JobHandle handle;
+
+			for (size_t first = 0; first < view.size(); first += chunkSize)
+			{
+				size_t last = std::min(first + chunkSize, view.size());
+				handle = gs(JobSystem)->submit([view, func, first, last]() mutable { 
+					view.each(func, first, last); }, handle);
+			}
 
-			return dynamic_cast<ComponentArray<T> *>(compArrays.at(compName).get())->getData(id);
+			gs(JobSystem)->wait(handle);
 		}
 
 		const std::string &getCompName(CompId compId);
+		CompId getCompCount();
 		CompId getCompId(const std::string &compName);
 
-		void signalEntityRemoved(EntityId id);
+		void signalEntityRemoved(EntityId id); // call before the entity's signature is cleared
 	};
 
 }
\ No newline at end of file
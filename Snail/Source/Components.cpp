@@ -1,4 +1,7 @@
 #include "Components.h"
+#include "Geometry.h"
+#include "Profiler.h"
+#include "Core.h"
 
 #include "GL/glew.h"
 #include "GLFW/glfw3.h"
@@ -12,94 +15,36 @@
 namespace Snail
 {
 
-	Vec2 ShapeComponent::findNewDir(Vec2 currPos, Vec2 scaleDir, Vec2 halfScale) const
-	{
-		Vec2 newDir; // displacement?
-		if (currPos.x > 0.f && scaleDir.x > 0.f || currPos.x < 0.f && scaleDir.x < 0.f)
-			newDir.x = fabs(currPos.x) / fabs(halfScale.x) * scaleDir.x;
-		if (currPos.y > 0.f && scaleDir.y > 0.f || currPos.y < 0.f && scaleDir.y < 0.f)
-			newDir.y = fabs(currPos.y) / fabs(halfScale.y) * scaleDir.y;
-		return newDir;
-	}
-
-	bool ShapeComponent::ifIsConvex(const Line &line) const
+	void TransformComponent::savePrevState()
 	{
-		std::vector<Vec2> positions;
-		for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
-			if (i != edges[*line.edge].p1 && i != edges[*line.edge].p2
-				&& vertices[i].type != VertexType::REMOVED)
-				positions.push_back(vertices[i].pos);
-		return line.ifIsOnOneSide(positions);
+		prevPos = pos;
+		prevScale = scale;
+		prevRot = rot;
+		hasPrevState = true;
 	}
 
-	bool ShapeComponent::ifIsOutside(const Line &line, unsigned i, unsigned j)
+	TransformComponent TransformComponent::interpolate(float alpha) const
 	{
-		crashIf(raycasts.empty(), "Raycasts vector is empty");
-		std::pair<unsigned, unsigned> distribution; // of outside (true) and inside (false) respectively
-		std::for_each(edges.begin(), edges.end(), [this](auto &elem) { elem.shldIgnore = false; });
+		TransformComponent transform = *this;
 
-		for (Vec2 raycast : raycasts)
+		if (hasPrevState)
 		{
-			Line ray = Line(raycast, line.p1.midpoint(line.p2));
-			unsigned intersections = 0;
-			
-			// only check with edges that are not removed and
-			// are outside (all edges are defaulted to outside, user has to manually set to inside for this to take effect)
-			for (const Line &obstacle : lines)
-				if (&obstacle != &line && edges[*obstacle.edge].type != EdgeType::REMOVED &&
-					edges[*obstacle.edge].isOutside && !edges[*obstacle.edge].shldIgnore)
-				{
-					IntersectData data = obstacle.findIntersection(ray, 0.f);
-
-					if (data.isIntersecting)
-					{
-						// interesects raycast at a vertex that might be connected to another edge that now should be ignored
-						if (Util::isEqual(data.t, 0.f) || Util::isEqual(data.t, 1.f))
-						{
-							// check which vertex it intersected
-							unsigned vertex = vertices[edges[*obstacle.edge].p1].pos.squareDistance
-							(data.intersection) < vertices[edges[*obstacle.edge].p2].pos.squareDistance
-							(data.intersection) ? edges[*obstacle.edge].p1 : edges[*obstacle.edge].p2;
-
-							std::for_each(edges.begin(), edges.end(), [this, vertex](auto &elem) {
-								if (elem.p1 == vertex || elem.p2 == vertex)
-									elem.shldIgnore = true;
-								});
-						}
-
-						++intersections;
-					}
-				}
-
-			if (intersections % 2)
-				++distribution.second;
-			else
-				++distribution.first;
+			transform.pos = prevPos + (pos - prevPos) * alpha;
+			transform.scale = prevScale + (scale - prevScale) * alpha;
+			transform.rot = Util::lerp(prevRot, rot, alpha);
 		}
 
-		return distribution.first > distribution.second;
+		return transform;
 	}
 
-	bool ShapeComponent::ifHasIntersection(const Line &line, unsigned i, unsigned j) const
+	Vec2 ShapeComponent::findNewDir(Vec2 currPos, Vec2 scaleDir, Vec2 halfScale) const
 	{
-		bool hasIntersection = false;
-
-		for (const Line &otherLine : lines)
-		{
-			// don't check intersection with adjacent or removed lines
-			const Edge &otherEdge = edges[*otherLine.edge];
-			if (otherEdge.p1 == i || otherEdge.p2 == i || otherEdge.p1 == j || otherEdge.p2 == j
-				|| otherEdge.type == EdgeType::REMOVED) // ADDED or REMOVED?
-				continue;
-
-			if (otherLine.findIntersection(line).isIntersecting)
-			{
-				hasIntersection = true;
-				break;
-			}
-		}
-
-		return hasIntersection;
+		Vec2 newDir; // displacement?
+		if (currPos.x > 0.f && scaleDir.x > 0.f || currPos.x < 0.f && scaleDir.x < 0.f)
+			newDir.x = fabs(currPos.x) / fabs(halfScale.x) * scaleDir.x;
+		if (currPos.y > 0.f && scaleDir.y > 0.f || currPos.y < 0.f && scaleDir.y < 0.f)
+			newDir.y = fabs(currPos.y) / fabs(halfScale.y) * scaleDir.y;
+		return newDir;
 	}
 
 	ShapeComponent::~ShapeComponent()
@@ -131,115 +76,45 @@ namespace Snail
 			}
 
 			glBindBuffer(GL_ARRAY_BUFFER, vboId);
-			glBufferData(GL_ARRAY_BUFFER, vbo.size() * sizeof(float), vbo.data(), GL_DYNAMIC_DRAW);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, vbo.size() * sizeof(float), vbo.data());
 			
 			std::for_each(lines.begin(), lines.end(), [](auto &elem) { elem.isDirty = true; });
 		}
 
+		if (!isDirty && (movedVertices.size() || addedEdges.size()))
+		{
+			profileScope("Shape edit");
+			applyEdits();
+		}
+		movedVertices.clear();
+		addedEdges.clear();
+
 		if (isDirty)
 		{
+			profileScope("Shape rebuild");
 			isDirty = false;
 
-			/*! ------------ Clear old buffers ------------ */
+			/*! ------------ Split intersections ------------ */
 
-			if (!vaoId || !vboId || !eboId)
-			{
-				crashIf(vaoId || vboId || eboId, "One or more of vaoId/vboId/eboId doesn't match");
-
-				glDeleteBuffers(1, &eboId);
-				glDeleteBuffers(1, &vboId);
-				glDeleteVertexArrays(1, &vaoId);
-			}
+			// crossing edges are replaced by added ones meeting at a vertex where they cross
+			Geometry::splitCrossings(vertices, edges);
 
 			/*! ------------ Initialise lines from edges ------------ */
 
-			lines.clear();
-			for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
-				lines.emplace_back(vertices[edges[i].p1].pos, vertices[edges[i].p2].pos, i);
-
-			/*! ------------ Check for intersections ------------ */
+			// existing lines are reused so their buffers aren't recreated
+			if (lines.size() > edges.size())
+				lines.erase(lines.begin() + edges.size(), lines.end());
 
-			for (unsigned i = 0; i < static_cast<unsigned>(lines.size()); ++i) // lines[i] == line1
-				for (unsigned j = 0; j < static_cast<unsigned>(lines.size()); ++j) // lines[j] == line2
-					if (i != j && edges[*lines[i].edge].type != EdgeType::REMOVED
-						&& edges[*lines[j].edge].type != EdgeType::REMOVED) // can't put together with next line
-					{
-						IntersectData data = lines[i].findIntersection(lines[j]);
-
-						if (data.isIntersecting)
-						{
-							// add new vertex at the intersection if it doesn't exist already
-							unsigned newVertexIdx = static_cast<unsigned>(std::find(vertices.begin(),
-								vertices.end(), Vertex(data.intersection)) - vertices.begin()); // largest index
-							unsigned lastIdx = static_cast<unsigned>(edges.size()); // bind to new edge
-							if (newVertexIdx == static_cast<unsigned>(vertices.size()))
-								vertices.emplace_back(data.intersection, VertexType::ADDED);
-
-							// add 4 edges to connect old points to new vertex
-							lines.emplace_back(lines[i].p1, data.intersection, lastIdx);
-							lines.emplace_back(lines[i].p2, data.intersection, lastIdx + 1);
-							lines.emplace_back(lines[j].p1, data.intersection, lastIdx + 2);
-							lines.emplace_back(lines[j].p2, data.intersection, lastIdx + 3);
-
-							// same as above
-							edges.emplace_back(edges[*lines[i].edge].p1, newVertexIdx, EdgeType::ADDED,
-								edges[*lines[i].edge].isOutside);
-							edges.emplace_back(edges[*lines[i].edge].p2, newVertexIdx, EdgeType::ADDED,
-								edges[*lines[i].edge].isOutside);
-							edges.emplace_back(edges[*lines[j].edge].p1, newVertexIdx, EdgeType::ADDED,
-								edges[*lines[j].edge].isOutside);
-							edges.emplace_back(edges[*lines[j].edge].p2, newVertexIdx, EdgeType::ADDED,
-								edges[*lines[j].edge].isOutside);
-
-							// remove the 2 intersecting edges
-							auto toRemove = std::find(edges.begin(), edges.end(),
-								Edge(edges[*lines[i].edge].p1, edges[*lines[i].edge].p2));
-							crashIf(toRemove == edges.end(), "Could not find edge");
-							toRemove->type = EdgeType::REMOVED;
-
-							// same as above
-							toRemove = std::find(edges.begin(), edges.end(),
-								Edge(edges[*lines[j].edge].p1, edges[*lines[j].edge].p2));
-							crashIf(toRemove == edges.end(), "Could not find edge");
-							toRemove->type = EdgeType::REMOVED;
-						}
-					}
+			for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
+				if (i < lines.size())
+					updateLine(i);
+				else
+					lines.emplace_back(vertices[edges[i].p1].pos, vertices[edges[i].p2].pos, i);
 
 			/*! ------------ Remove dangling edges and vertices ------------ */
 
-			bool didVertexGetRemoved = true;
-
 			// dangling edges == those with vertices that appear fewer than twice
-			// repeat unti no more needs to be removed
-			while (didVertexGetRemoved)
-			{
-				didVertexGetRemoved = false;
-
-				for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
-				{
-					if (vertices[i].type == VertexType::REMOVED)
-						continue;
-
-					int count = 0;
-					std::vector<Edge *> edgesWithCurrVertex;
-
-					for (Edge &edge : edges)
-						if (edge.type != EdgeType::REMOVED && (edge.p1 == i || edge.p2 == i))
-						{
-							++count;
-							edgesWithCurrVertex.push_back(&edge);
-						}
-
-					if (count < 2)
-					{
-						vertices[i].type = VertexType::REMOVED;
-						std::for_each(edgesWithCurrVertex.begin(), edgesWithCurrVertex.end(),
-							[](auto &elem) { elem->type = EdgeType::REMOVED; });
-						didVertexGetRemoved = true;
-						break; // next loop will check the rest
-					}
-				}
-			}
+			Geometry::pruneDangling(vertices, edges);
 
 			/*! ------------ Initialise VBO ------------ */
 
@@ -254,85 +129,28 @@ namespace Snail
 
 			/*! ------------ Triangulation ------------ */
 
-			// add edges to triangulate shape, but only if it doesn't change the shape
-			// uses raycasting to determine if an edge is inside or outside the shape, and thus whether to add it
-			for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
-			{
-				if (vertices[i].type == VertexType::REMOVED)
-					continue;
-				
-				for (unsigned j = i + 1; j < static_cast<unsigned>(vertices.size()); ++j)
-				{
-					if (vertices[j].type == VertexType::REMOVED)
-						continue;
-
-					// check if line already exists
-					// cannot std::sort edges then std::binary_search because lines have indices into edges
-					// and cannot use edge * instead of indices because std::vector may allocate new memory blocks
-					if (std::find(edges.begin(), edges.end(), Edge(i, j)) != edges.end())
-						continue;
-
-					Line currLine = Line(vertices[i].pos, vertices[j].pos);
-
-					// check if line intersects any other lines or if it is outside the shape
-					if (!ifHasIntersection(currLine, i, j) && !ifIsOutside(currLine, i, j))
-					{
-						currLine.edge = static_cast<unsigned>(edges.size());
-						lines.push_back(currLine);
-						edges.emplace_back(i, j, EdgeType::ADDED, false);
-					}
-				}
-			}
-
-			/*! ------------ Initialise triangles ------------ */
-
+			// faces are filled by the even odd rule over outside edges, the same as casting a ray out of them
+			faces.clear();
+			faceStarts.clear();
 			triangles.clear();
 
-			for (size_t i = 0; i < edges.size(); ++i) // edges[i] == edge1
+			if (triangulationMode == TriangulationMode::EAR_CLIPPING)
 			{
-				if (edges[i].type == EdgeType::REMOVED)
-					continue;
-
-				for (size_t j = i + 1; j < edges.size(); ++j) // edges[j] == edge2
+				// kept per face so edits only have to retriangulate the faces they touch
+				faces = Geometry::findFilledFaces(vertices, edges);
+				for (const Geometry::Face &face : faces)
 				{
-					if (edges[j].type == EdgeType::REMOVED)
-						continue;
-
-					// find the repeat vertex if any (i.e. the joint of 2 connected edges)
-					std::array<unsigned, 4> edgeVertices = { edges[i].p1, edges[i].p2, edges[j].p1, edges[j].p2 };
-					std::sort(edgeVertices.begin(), edgeVertices.end());
-					auto duplicate = std::adjacent_find(edgeVertices.begin(), edgeVertices.end());
-					if (duplicate == edgeVertices.end())
-						continue;
-
-					// craft the new edge to find based on the non-repeated vertex
-					unsigned newP1 = edges[i].p1 == *duplicate ? edges[i].p2 : edges[i].p1;
-					unsigned newP2 = edges[j].p1 == *duplicate ? edges[j].p2 : edges[j].p1;
-					if (newP1 > newP2)
-						std::swap(newP1, newP2); // make newP1 < newP2
-
-					auto edge3 = std::find_if(edges.begin(), edges.end(),
-						[newP1, newP2](const auto &elem) { return elem.p1 == newP1 && elem.p2 == newP2
-						&& elem.type != EdgeType::REMOVED; });
-
-					// if such an edge exists, a valid triangle can be formed (also arrange its vertices in ascending order)
-					if (edge3 != edges.end())
-					{
-						std::array<unsigned, 3> points{ newP1, newP2, *duplicate };
-						std::sort(points.begin(), points.end());
-						Triangle toAdd = Triangle(points[0], points[1], points[2]);
-						if (std::find(triangles.begin(), triangles.end(), toAdd) == triangles.end())
-							triangles.emplace_back(toAdd);
-					}
+					faceStarts.push_back(static_cast<unsigned>(triangles.size()));
+					Geometry::earClip(vertices, face, triangles);
 				}
+				faceStarts.push_back(static_cast<unsigned>(triangles.size()));
 			}
-
-			// debug info
-			printv(edges);
-			printv(triangles);
+			else
+				triangles = Geometry::triangulate(vertices, edges, triangulationMode);
 
 			/*! ------------ Initialise EBO ------------ */
 
+			ebo.clear();
 			for (const Triangle &triangle : triangles)
 			{
 				ebo.push_back(triangle.p1);
@@ -342,21 +160,23 @@ namespace Snail
 
 			/*! ------------ Initialise OpenGL stuff ------------ */
 
-			// init vaoId
-			glGenVertexArrays(1, &vaoId);
-			glBindVertexArray(vaoId);
+			// init vaoId, vboId and eboId the first time, after that they're only refilled
+			if (!vaoId)
+			{
+				glGenVertexArrays(1, &vaoId);
+				glGenBuffers(1, &vboId);
+				glGenBuffers(1, &eboId);
+
+				// init attributes
+				glBindVertexArray(vaoId);
+				glBindBuffer(GL_ARRAY_BUFFER, vboId);
+				glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, static_cast<void *>(0));
+				glEnableVertexAttribArray(0);
+			}
 
-			// init vboId
-			glGenBuffers(1, &vboId);
+			glBindVertexArray(vaoId);
 			glBindBuffer(GL_ARRAY_BUFFER, vboId);
-
-			// init attributes
 			glBufferData(GL_ARRAY_BUFFER, vbo.size() * sizeof(float), vbo.data(), GL_DYNAMIC_DRAW);
-			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 2, static_cast<void *>(0));
-			glEnableVertexAttribArray(0);
-
-			// init eboId
-			glGenBuffers(1, &eboId);
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboId);
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, ebo.size() * sizeof(unsigned), ebo.data(), GL_DYNAMIC_DRAW);
 
@@ -364,6 +184,178 @@ namespace Snail
 		}
 	}
 
+	void ShapeComponent::moveVertex(unsigned vertex, Vec2 pos)
+	{
+		// keep where it was at the last update if it's moved more than once
+		if (std::none_of(movedVertices.begin(), movedVertices.end(), [vertex](auto &elem) { return elem.first == vertex; }))
+			movedVertices.push_back({ vertex, vertices[vertex].pos });
+
+		vertices[vertex].pos = pos;
+	}
+
+	void ShapeComponent::addEdge(unsigned p1, unsigned p2, bool isOutside)
+	{
+		edges.emplace_back(p1, p2, EdgeType::NONE, isOutside);
+		addedEdges.push_back(static_cast<unsigned>(edges.size() - 1));
+	}
+
+	void ShapeComponent::applyEdits()
+	{
+		// outside edges change which faces are filled, and delaunay triangles aren't kept per face
+		if (triangulationMode != TriangulationMode::EAR_CLIPPING || vbo.size() != vertices.size() * 2 ||
+			lines.size() + addedEdges.size() != edges.size())
+		{
+			isDirty = true;
+			return;
+		}
+
+		/*! ------------ Moved vertices ------------ */
+
+		// each move is checked from where the ones before it left the shape, so it only has to be safe on its own
+		for (auto &[vertex, from] : movedVertices)
+			std::swap(vertices[vertex].pos, from);
+
+		for (auto &[vertex, from] : movedVertices)
+		{
+			std::swap(vertices[vertex].pos, from);
+			isDirty = isDirty || !Geometry::ifIsMoveSafe(vertices, edges, vertex, from);
+		}
+
+		if (isDirty)
+			return;
+
+		std::vector<bool> isMoved(vertices.size(), false);
+		glBindBuffer(GL_ARRAY_BUFFER, vboId);
+
+		for (auto &[vertex, from] : movedVertices)
+		{
+			isMoved[vertex] = true;
+			vbo[vertex * 2] = vertices[vertex].pos.x;
+			vbo[vertex * 2 + 1] = vertices[vertex].pos.y;
+			glBufferSubData(GL_ARRAY_BUFFER, vertex * 2 * sizeof(float), 2 * sizeof(float), &vbo[vertex * 2]);
+		}
+
+		for (unsigned i = 0; i < static_cast<unsigned>(lines.size()); ++i)
+			if (isMoved[edges[i].p1] || isMoved[edges[i].p2])
+				updateLine(i);
+
+		// only the faces with a moved vertex on them change
+		auto ifHasMoved = [&isMoved](const std::vector<unsigned> &loop) {
+			return std::any_of(loop.begin(), loop.end(), [&isMoved](unsigned vertex) { return isMoved[vertex]; }); };
+
+		for (unsigned i = 0; i < static_cast<unsigned>(faces.size()); ++i)
+			if (ifHasMoved(faces[i].outer) || std::any_of(faces[i].holes.begin(), faces[i].holes.end(), ifHasMoved))
+				replaceFace(i, { faces[i] });
+
+		/*! ------------ Added edges ------------ */
+
+		for (unsigned edge : addedEdges)
+		{
+			const Edge &added = edges[edge];
+			if (added.isOutside || vertices[added.p1].type == VertexType::REMOVED ||
+				vertices[added.p2].type == VertexType::REMOVED || !Geometry::ifIsEdgeClear(vertices, edges, edge))
+			{
+				isDirty = true;
+				return;
+			}
+
+			lines.emplace_back(vertices[added.p1].pos, vertices[added.p2].pos, edge);
+
+			// an inside edge through a face either splits it in 2 or joins a hole to its outside, anywhere else it
+			// changes nothing
+			Vec2 mid = (vertices[added.p1].pos + vertices[added.p2].pos) / 2.f;
+			auto ifIsInLoop = [this, mid](const std::vector<unsigned> &loop) {
+				return Geometry::ifIsInPolygon(mid, vertices, loop); };
+
+			for (unsigned i = 0; i < static_cast<unsigned>(faces.size()); ++i)
+				if (ifIsInLoop(faces[i].outer) && std::none_of(faces[i].holes.begin(), faces[i].holes.end(), ifIsInLoop))
+				{
+					std::vector<Edge> boundary;
+					auto addLoop = [&boundary](const std::vector<unsigned> &loop) {
+						for (size_t j = 0; j < loop.size(); ++j)
+							boundary.emplace_back(loop[j], loop[(j + 1) % loop.size()]); };
+
+					addLoop(faces[i].outer);
+					std::for_each(faces[i].holes.begin(), faces[i].holes.end(), addLoop);
+					std::sort(boundary.begin(), boundary.end());
+
+					// refind the faces of just this face's loops and the new edge, where loop edges with the face on
+					// both sides are inside it and the rest enclose it
+					std::vector<Edge> graph = { added };
+					for (size_t j = 0, k = 0; j < boundary.size(); j = k)
+					{
+						for (k = j; k < boundary.size() && boundary[k] == boundary[j]; ++k);
+						graph.emplace_back(boundary[j].p1, boundary[j].p2, EdgeType::NONE, k - j == 1);
+					}
+
+					replaceFace(i, Geometry::findFilledFaces(vertices, graph));
+					break;
+				}
+		}
+	}
+
+	void ShapeComponent::replaceFace(unsigned face, std::vector<Geometry::Face> newFaces)
+	{
+		unsigned first = faceStarts[face], count = faceStarts[face + 1] - first;
+
+		std::vector<Triangle> newTriangles;
+		std::vector<unsigned> newStarts;
+		for (const Geometry::Face &newFace : newFaces)
+		{
+			newStarts.push_back(first + static_cast<unsigned>(newTriangles.size()));
+			Geometry::earClip(vertices, newFace, newTriangles);
+		}
+
+		faces.erase(faces.begin() + face);
+		faces.insert(faces.begin() + face, newFaces.begin(), newFaces.end());
+		faceStarts.erase(faceStarts.begin() + face);
+		faceStarts.insert(faceStarts.begin() + face, newStarts.begin(), newStarts.end());
+
+		glBindVertexArray(vaoId);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboId);
+
+		// ear clipping gives the same number of triangles for the same vertices and holes, so usually only this
+		// face's part of the ebo is rewritten
+		if (newTriangles.size() == count)
+		{
+			std::copy(newTriangles.begin(), newTriangles.end(), triangles.begin() + first);
+			for (unsigned i = first; i < first + count; ++i)
+			{
+				ebo[i * 3] = triangles[i].p1;
+				ebo[i * 3 + 1] = triangles[i].p2;
+				ebo[i * 3 + 2] = triangles[i].p3;
+			}
+
+			if (count)
+				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * 3 * sizeof(unsigned), count * 3 * sizeof(unsigned),
+					&ebo[first * 3]);
+			return;
+		}
+
+		triangles.erase(triangles.begin() + first, triangles.begin() + first + count);
+		triangles.insert(triangles.begin() + first, newTriangles.begin(), newTriangles.end());
+		for (size_t i = face + newFaces.size(); i < faceStarts.size(); ++i)
+			faceStarts[i] = faceStarts[i] + static_cast<unsigned>(newTriangles.size()) - count;
+
+		ebo.clear();
+		for (const Triangle &triangle : triangles)
+		{
+			ebo.push_back(triangle.p1);
+			ebo.push_back(triangle.p2);
+			ebo.push_back(triangle.p3);
+		}
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, ebo.size() * sizeof(unsigned), ebo.data(), GL_DYNAMIC_DRAW);
+	}
+
+	void ShapeComponent::updateLine(unsigned edge)
+	{
+		Line &line = lines[edge];
+		line.p1 = vertices[edges[edge].p1].pos;
+		line.p2 = vertices[edges[edge].p2].pos;
+		line.edge = edge;
+		line.isDirty = true;
+	}
+
 	void ShapeComponent::translate(Vec2 dir)
 	{
 		isTransformDirty = true; 
@@ -375,11 +367,10 @@ namespace Snail
 			line.p2 += dir;
 		}
 
-		for (Vec2 &raycast : raycasts)
-			raycast += dir;
-
 		for (Vertex &vertex : vertices)
 			vertex.pos += dir;
+		for (auto &[vertex, from] : movedVertices)
+			from += dir;
 	}
 
 	void ShapeComponent::scale(Vec2 dir, Vec2 halfScale)
@@ -394,11 +385,10 @@ namespace Snail
 			line.p2 += findNewDir(line.p2, dir, halfScale) + halfDir;
 		}
 
-		for (Vec2 &raycast : raycasts)
-			raycast += findNewDir(raycast, dir, halfScale) + halfDir;
-
 		for (Vertex &vertex : vertices)
 			vertex.pos += findNewDir(vertex.pos, dir, halfScale) + halfDir;
+		for (auto &[vertex, from] : movedVertices)
+			from += findNewDir(from, dir, halfScale) + halfDir;
 	}
 
 	void ShapeComponent::rotate(float rad, Vec2 origin)
@@ -412,11 +402,10 @@ namespace Snail
 			line.p2 = Util::rotate(line.p2, rad, origin);
 		}
 
-		for (Vec2 &raycast : raycasts)
-			raycast = Util::rotate(raycast, rad, origin);
-
 		for (Vertex &vertex : vertices)
 			vertex.pos = Util::rotate(vertex.pos, rad, origin);
+		for (auto &[vertex, from] : movedVertices)
+			from = Util::rotate(from, rad, origin);
 	}
 
 
@@ -2,6 +2,7 @@
 
 #include "Utility.h"
 #include "Types.h"
+#include "Geometry.h"
 
 #include <set>
 
@@ -13,16 +14,23 @@ namespace Snail
 		Vec2 pos;
 		Vec2 scale;
 		float rot;
+
+		// state at the start of the latest fixed step, so rendering can blend between steps
+		Vec2 prevPos;
+		Vec2 prevScale;
+		float prevRot = 0.f;
+		bool hasPrevState = false;
+
+		void savePrevState();
+		TransformComponent interpolate(float alpha) const; // alpha of 0 is the previous step, 1 is the latest
 	};
 
 	struct ShapeComponent
 	{
 		std::vector<Vertex> vertices; // can modify
 		std::vector<Edge> edges; // can modify
-		std::vector<Triangle> triangles;
-		std::vector<Line> lines;
-		std::vector<Vec2> raycasts = { { -999.f, -999.f }, { 0.f, -999.f }, { 999.f, -999.f }, { -999.f, 0.f },
-			{ 999.f, 0.f }, { -999.f, 999.f }, { 0.f, 999.f }, { 999.f, 999.f } }; // start of raycast
+		std::vector<Triangle> triangles; // grouped by face when ear clipping
+		std::vector<Line> lines; // one per edge
 
 		std::vector<float> vbo;
 		std::vector<unsigned> ebo;
@@ -36,22 +44,35 @@ namespace Snail
 		Color strokeColor;
 		Color fillColor = Color(0.2f, 0.6f);
 		bool shldUseFillColor = true; // use same colour for whole shape or use vertex's colour
+		TriangulationMode triangulationMode = TriangulationMode::EAR_CLIPPING; // set isDirty after changing
 		
 		ShapeComponent() = default;
 		~ShapeComponent();
 
 		void update(); // call every frame before drawing
 
+		// edits that only retriangulate the faces they touch, falling back to a full rebuild if they'd change the
+		// shape's topology or the triangulation is delaunay
+		void moveVertex(unsigned vertex, Vec2 pos);
+		void addEdge(unsigned p1, unsigned p2, bool isOutside = true); // only inside edges are incremental
+
 		void translate(Vec2 dir); // assume transform component's pos has been updated
 		void scale(Vec2 dir, Vec2 halfScale); // assume transform component's pos and scale has been updated
 		void rotate(float rad, Vec2 origin = Vec2()); // assume transform component's rot has been updated
 
 	private:
 
+		// the filled faces from the last rebuild, faceStarts[i] is the first of face i's triangles
+		std::vector<Geometry::Face> faces;
+		std::vector<unsigned> faceStarts;
+
+		std::vector<std::pair<unsigned, Vec2>> movedVertices; // and where they were at the last update
+		std::vector<unsigned> addedEdges;
+
 		Vec2 findNewDir(Vec2 currPos, Vec2 scaleDir, Vec2 halfScale) const;
-		bool ifIsConvex(const Line &line) const;
-		bool ifIsOutside(const Line &line, unsigned i, unsigned j);
-		bool ifHasIntersection(const Line &line, unsigned i, unsigned j) const;
+		void applyEdits(); // sets isDirty instead if they can't be done incrementally
+		void replaceFace(unsigned face, std::vector<Geometry::Face> newFaces);
+		void updateLine(unsigned edge);
 	};
 
 }
\ No newline at end of file
@@ -2,9 +2,13 @@
 #include "Debug.h"
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "CommandBuffer.h"
 #include "Timer.h"
 #include "AssetManager.h"
 #include "Renderer.h"
+#include "JobSystem.h"
+#include "Scheduler.h"
+#include "Profiler.h"
 #include "Editor.h"
 
 #include <iostream> // for debugging
@@ -19,6 +23,8 @@ namespace Snail
 	{
 
 		std::vector<std::unique_ptr<System>> systems;
+		std::vector<System **> systemSlots; // to empty them when systems are freed
+		Scheduler scheduler;
 
 		GLFWwindow *windowPtr;
 		Window window = { { 640.f, 640.f }, "Snail Engine" };
@@ -29,13 +35,20 @@ namespace Snail
 			systems.push_back(std::make_unique<T>());
 			systems.back()->systemName = typeid(T).name();
 			systems.back()->shldProfile = shldProfile;
+
+			crashIf(systemSlot<T>, "System " + Util::quote(typeid(T).name()) + " was added more than once");
+			systemSlot<T> = systems.back().get();
+			systemSlots.push_back(&systemSlot<T>);
 		}
 
 		void init()
 		{
 			// add systems
+			addSystem<JobSystem>(false);
+			addSystem<Profiler>(false);
 			addSystem<EntityManager>(false);
 			addSystem<ComponentManager>(false);
+			addSystem<CommandBuffer>(false);
 			addSystem<Time>(true);
 			addSystem<AssetManager>(false);
 			addSystem<Renderer>(true);
@@ -83,7 +96,10 @@ namespace Snail
 
 			// initialise systems
 			for (auto &system : systems)
+			{
+				system->profileLabel = gs(Profiler)->internLabel(system->systemName);
 				system->init();
+			}
 		}
 
 		void update()
@@ -109,6 +125,12 @@ namespace Snail
 			gs(Renderer)->useVertFragShader("Default + Default");
 			gs(Time)->setFps(60.f);
 
+			gs(Time)->setTickRate(60.f);
+
+			std::vector<System *> toRun, toTick;
+			for (auto &system : systems)
+				(system->isFixedStep ? toTick : toRun).push_back(system.get());
+
 			while (!glfwWindowShouldClose(windowPtr))
 			{
 				gs(Time)->beginDt();
@@ -121,8 +143,17 @@ namespace Snail
 				ImGui::NewFrame();
 				gs(Editor)->createDockspace();
 
-				for (auto &system : systems)
-					system->update();
+				// simulation catches up in fixed steps, rendering blends between the last two of them
+				if (!toTick.empty())
+					for (unsigned ticks = gs(Time)->beginTicks(); ticks; --ticks)
+					{
+						gs(ComponentManager)->parallelForEach<TransformComponent>(
+							[](EntityId, TransformComponent &transform) { transform.savePrevState(); });
+						scheduler.run(toTick);
+					}
+
+				// systems that do not conflict run in parallel, structural changes are applied between them
+				scheduler.run(toRun);
 
 				// More imgui stuff
 				ImGui::Render();
@@ -152,6 +183,10 @@ namespace Snail
 			for (size_t i = systems.size(); i-- > 0; ) // --> is the "approach to" operator
 				systems[i]->free();
 			systems.clear();
+
+			for (System **slot : systemSlots)
+				*slot = nullptr;
+			systemSlots.clear();
 		}
 
 		const std::vector<std::unique_ptr<System>> &getSystems()
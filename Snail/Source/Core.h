@@ -15,15 +15,15 @@ namespace Snail
 		void free();
 		const std::vector<std::unique_ptr<System>> &getSystems();
 
+		// one slot per system type, filled in when the system is added so getSystem is a single load
+		template <typename T>
+		inline System *systemSlot = nullptr;
+
 		template <typename T>
 		T *getSystem()
 		{
-			for (auto &system : getSystems())
-				if (T *ptr = dynamic_cast<T *>(system.get()))
-					return ptr;
-
-			crashIf(true, "System " + Util::quote(typeid(T).name()) + " does not exist"s);
-			return nullptr;
+			crashIf(!systemSlot<T>, "System " + Util::quote(typeid(T).name()) + " does not exist"s);
+			return static_cast<T *>(systemSlot<T>);
 		}
 
 	}
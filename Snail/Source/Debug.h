@@ -1,8 +1,8 @@
 #pragma once
 
-#include "System.h"
-
+#include <string>
 #include <vector>
+#include <ostream>
 
 namespace Snail
 {
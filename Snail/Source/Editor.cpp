@@ -3,6 +3,7 @@
 #include "Timer.h"
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "Profiler.h"
 
 namespace Snail
 {
@@ -77,6 +78,15 @@ namespace Snail
 		ImGui::Begin(name.c_str());
 
 		ImGui::Text("FPS: %.2f", 1.f / gs(Time)->getDt().actual);
+		const PacingStats &pacing = gs(Time)->getPacingStats();
+		ImGui::Text("Frame lateness: %.3f ms (avg %.3f ms, max %.3f ms)", pacing.last * 1e3f, pacing.average * 1e3f,
+			pacing.max * 1e3f);
+		gs(Editor)->addSpace(3);
+
+		if (gs(Profiler)->isCapturing())
+			ImGui::Text("Capturing trace...");
+		else if (ImGui::Button("Capture trace (120 frames)"))
+			gs(Profiler)->beginCapture(120);
 		gs(Editor)->addSpace(3);
 
 		for (const auto &[name, window] : gs(Editor)->getWindows())
@@ -113,7 +123,7 @@ namespace Snail
 		for (EntityId entity : gs(EntityManager)->getEntityIds())
 		{
 			ImGui::Text("Entity %llu", entity);
-			for (CompId id = 0; id < MAX_COMPONENTS; ++id)
+			for (CompId id = 0; id < gs(ComponentManager)->getCompCount(); ++id)
 				if (gs(EntityManager)->hasComponent(entity, id))
 				{
 					ImGui::Text("%s", gs(ComponentManager)->getCompName(id).c_str());
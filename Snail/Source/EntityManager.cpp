@@ -8,10 +8,16 @@
 namespace Snail
 {
 
+	Query::Query(Signature _signature)
+		: signature(_signature)
+	{
+
+	}
+
 	void EntityManager::init()
 	{
-		for (EntityId i = 0; i < MAX_ENTITIES; ++i)
-			usableIds.push(i);
+		isExclusive = false; // update does nothing
+		reserveEntities(BIG);
 	}
 
 	void EntityManager::update()
@@ -24,43 +30,144 @@ namespace Snail
 
 	}
 
-	const std::unordered_set<EntityId> &EntityManager::getEntityIds()
+	const std::vector<EntityId> &EntityManager::getEntityIds()
+	{
+		return liveIds;
+	}
+
+	void EntityManager::reserveEntities(unsigned count)
+	{
+		crashIf(count > MAX_ENTITIES, "Cannot reserve more than " + toStr(MAX_ENTITIES) + " entities");
+		liveIds.reserve(count);
+		liveIndices.reserve(count);
+		generations.reserve(count);
+		entities.reserve(count);
+	}
+
+	unsigned EntityManager::allocateIndex()
+	{
+		unsigned index;
+
+		if (freeIndices.empty())
+		{
+			crashIf(nextIndex >= MAX_ENTITIES, "Max entities reached");
+			index = nextIndex++;
+			liveIndices.push_back(0);
+			generations.push_back(0);
+			entities.emplace_back();
+		}
+		else
+		{
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+
+		liveIndices[index] = liveIds.size();
+		liveIds.push_back(makeEntityId(index, generations[index]));
+		return index;
+	}
+
+	void EntityManager::freeEntity(EntityId id)
 	{
-		return usedIds;
+		crashIf(!isEntityAlive(id), "Entity " + toStr(id) + " is not alive");
+		gs(ComponentManager)->signalEntityRemoved(id);
+		setSignature(id, Signature()); // also removes it from all queries
+		unsigned index = getEntityIndex(id);
+
+		// swap and pop
+		EntityId last = liveIds.back();
+		liveIds[liveIndices[index]] = last;
+		liveIndices[getEntityIndex(last)] = liveIndices[index];
+		liveIds.pop_back();
+
+		// invalidate every copy of this id that is still around
+		generations[index] = (generations[index] + 1) & ENTITY_GENERATION_MASK;
+		freeIndices.push_back(index);
 	}
 
 	EntityId EntityManager::addEntity()
 	{
-		crashIf(usableIds.empty(), "Max entities reached");
-		EntityId newId = usableIds.front();
-		usedIds.insert(newId);
-		usableIds.pop();
-		return newId;
+		return liveIds[liveIndices[allocateIndex()]];
+	}
+
+	std::vector<EntityId> EntityManager::addEntities(unsigned count, Signature signature)
+	{
+		crashIf(count > MAX_ENTITIES - liveIds.size(), "Max entities reached");
+		std::vector<EntityId> newIds;
+		newIds.reserve(count);
+
+		for (unsigned i = 0; i < count; ++i)
+		{
+			unsigned index = allocateIndex();
+			entities[index] = signature;
+			newIds.push_back(liveIds.back());
+		}
+
+		// every new entity has the same signature so each query either takes all of them or none
+		for (Query &query : queries)
+			if (signature.contains(query.signature))
+			{
+				for (EntityId id : newIds)
+				{
+					query.indices[getEntityIndex(id)] = query.entityIds.size();
+					query.entityIds.push_back(id);
+				}
+			}
+
+		return newIds;
 	}
 
 	void EntityManager::removeEntity(EntityId id)
 	{
-		crashIf(usableIds.size() == MAX_ENTITIES, "No entities to remove");
-		usedIds.erase(id);
-		usableIds.push(id);
+		freeEntity(id);
 		gs(Time)->stopTimer(id);
 	}
 
+	void EntityManager::removeEntities(const std::vector<EntityId> &ids)
+	{
+		for (EntityId id : ids)
+			freeEntity(id);
+		gs(Time)->stopTimers(ids);
+	}
+
 	bool EntityManager::isEntityAlive(EntityId id)
 	{
-		return usedIds.count(id);
+		unsigned index = getEntityIndex(id);
+		return index < nextIndex && generations[index] == getEntityGeneration(id);
 	}
 
 	void EntityManager::setSignature(EntityId id, Signature signature)
 	{
-		crashIf(id >= MAX_ENTITIES, "Entity with id " + toStr(id) + " is out of bounds");
-		entities[id] = signature;
+		crashIf(!isEntityAlive(id), "Entity " + toStr(id) + " is not alive");
+		unsigned index = getEntityIndex(id);
+
+		for (Query &query : queries)
+		{
+			bool wasInQuery = entities[index].contains(query.signature);
+			bool isInQuery = signature.contains(query.signature);
+
+			if (isInQuery && !wasInQuery)
+			{
+				query.indices[index] = query.entityIds.size();
+				query.entityIds.push_back(id);
+			}
+			else if (!isInQuery && wasInQuery)
+			{
+				// swap and pop
+				EntityId last = query.entityIds.back();
+				query.entityIds[query.indices[index]] = last;
+				query.indices[getEntityIndex(last)] = query.indices[index];
+				query.entityIds.pop_back();
+			}
+		}
+
+		entities[index] = signature;
 	}
 
 	Signature EntityManager::getSignature(EntityId id)
 	{
-		crashIf(id >= MAX_ENTITIES, "Entity with id " + toStr(id) + " is out of bounds");
-		return entities[id];
+		crashIf(!isEntityAlive(id), "Entity " + toStr(id) + " is not alive");
+		return entities[getEntityIndex(id)];
 	}
 
 	bool EntityManager::hasComponent(EntityId entity, CompId comp)
@@ -73,7 +180,7 @@ namespace Snail
 		Signature toCompare;
 		for (const std::string &comp : comps)
 			toCompare.set(gs(ComponentManager)->getCompId(comp));
-		return (toCompare | getSignature(entity)) == Signature().set();
+		return getSignature(entity).intersects(toCompare);
 	}
 
 	bool EntityManager::hasAllComponents(EntityId entity, const std::vector<std::string> &comps)
@@ -81,7 +188,31 @@ namespace Snail
 		Signature toCompare;
 		for (const std::string &comp : comps)
 			toCompare.set(gs(ComponentManager)->getCompId(comp));
-		return (toCompare & getSignature(entity)) == toCompare;
+		return getSignature(entity).contains(toCompare);
+	}
+
+	size_t EntityManager::addQuery(Signature signature)
+	{
+		for (size_t i = 0; i < queries.size(); ++i)
+			if (queries[i].signature == signature)
+				return i;
+
+		Query &query = queries.emplace_back(signature);
+		query.entityIds.reserve(liveIds.size());
+		for (EntityId id : liveIds)
+			if (entities[getEntityIndex(id)].contains(signature))
+			{
+				query.indices[getEntityIndex(id)] = query.entityIds.size();
+				query.entityIds.push_back(id);
+			}
+
+		return queries.size() - 1;
+	}
+
+	const std::vector<EntityId> &EntityManager::getQueryEntityIds(size_t query)
+	{
+		crashIf(query >= queries.size(), "Invalid query " + toStr(query));
+		return queries[query].entityIds;
 	}
 
 }
\ No newline at end of file
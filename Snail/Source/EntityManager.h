@@ -3,19 +3,36 @@
 #include "System.h"
 #include "Utility.h"
 #include "Components.h"
+#include "PagedArray.h"
 
-#include <queue>
-#include <unordered_set>
-#include <array>
+#include <deque>
 
 namespace Snail
 {
 
+	// entities whose signature contains the query's signature, kept up to date in setSignature
+	struct Query
+	{
+		Signature signature;
+		std::vector<EntityId> entityIds;
+		PagedArray<size_t> indices; // entity index to index in entityIds, for removal
+
+		explicit Query(Signature _signature = Signature());
+	};
+
 	class EntityManager : public System
 	{
-		std::queue<EntityId> usableIds;
-		std::unordered_set<EntityId> usedIds; // live entity ids
-		std::array<Signature, MAX_ENTITIES> entities; // all entities
+		unsigned nextIndex = 0; // entity indices from here onwards have never been used
+		std::vector<unsigned> freeIndices; // indices of removed entities that can be reused
+		std::vector<EntityId> liveIds; // packed so iterating through all entities is a linear scan
+		// the following are indexed by entity index and grow whenever a new index is used
+		std::vector<size_t> liveIndices; // index in liveIds, for removal
+		std::vector<unsigned> generations; // current generation of each entity index
+		std::vector<Signature> entities; // all entities
+		std::deque<Query> queries; // deque so views can keep references to entity lists
+
+		unsigned allocateIndex(); // also adds the new entity to the back of liveIds
+		void freeEntity(EntityId id);
 
 	public:
 
@@ -23,10 +40,14 @@ namespace Snail
 		void update() override;
 		void free() override;
 
-		const std::unordered_set<EntityId> &getEntityIds();
+		const std::vector<EntityId> &getEntityIds();
+		void reserveEntities(unsigned count); // call at startup if the rough entity count is known
 		
 		EntityId addEntity();
 		void removeEntity(EntityId id);
+		// for spawning or despawning many entities at once, signature is given to every new entity
+		std::vector<EntityId> addEntities(unsigned count, Signature signature = Signature());
+		void removeEntities(const std::vector<EntityId> &ids);
 		bool isEntityAlive(EntityId id);
 
 		void setSignature(EntityId id, Signature signature);
@@ -34,6 +55,9 @@ namespace Snail
 		bool hasComponent(EntityId entity, CompId comp);
 		bool hasAnyComponents(EntityId entity, const std::vector<std::string> &comps);
 		bool hasAllComponents(EntityId entity, const std::vector<std::string> &comps);
+
+		size_t addQuery(Signature signature); // returns the existing query if there is one
+		const std::vector<EntityId> &getQueryEntityIds(size_t query);
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,1726 @@
+#include "Geometry.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <queue>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Snail
+{
+
+	namespace Geometry
+	{
+
+		namespace
+		{
+
+			constexpr unsigned NONE = static_cast<unsigned>(-1);
+			constexpr float MERGE_TOLERANCE = 0.00001f;
+
+			double orientCoords(double ax, double ay, double bx, double by, double cx, double cy)
+			{
+				return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+			}
+
+			struct GraphEdge
+			{
+				unsigned p1, p2; // p1 < p2
+				bool isOutside;
+			};
+
+			// edges that aren't removed, sorted, with coincident ones merged so 2 outside edges on top of each other 
+			// cancel out like they would for a ray. vertices in the same place are merged into the lowest of them first,
+			// so every triangulation mode sees the same graph
+			std::vector<GraphEdge> collectEdges(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges)
+			{
+				std::vector<unsigned> used;
+				for (const Edge &edge : edges)
+					if (edge.type != EdgeType::REMOVED && edge.p1 != edge.p2 &&
+						vertices[edge.p1].type != VertexType::REMOVED && vertices[edge.p2].type != VertexType::REMOVED)
+					{
+						used.push_back(edge.p1);
+						used.push_back(edge.p2);
+					}
+				std::sort(used.begin(), used.end(), [&vertices](unsigned a, unsigned b) {
+					Vec2 posA = vertices[a].pos, posB = vertices[b].pos;
+					return posA.x < posB.x || (posA.x == posB.x && (posA.y < posB.y || (posA.y == posB.y && a < b))); });
+
+				std::vector<unsigned> merged(vertices.size(), NONE);
+				for (size_t i = 0; i < used.size(); ++i)
+					merged[used[i]] = i && vertices[used[i - 1]].pos == vertices[used[i]].pos ? merged[used[i - 1]] : used[i];
+
+				std::vector<GraphEdge> graph;
+				for (const Edge &edge : edges)
+				{
+					if (edge.type == EdgeType::REMOVED || edge.p1 == edge.p2 ||
+						vertices[edge.p1].type == VertexType::REMOVED || vertices[edge.p2].type == VertexType::REMOVED)
+						continue;
+
+					unsigned p1 = merged[edge.p1], p2 = merged[edge.p2];
+					if (p1 != p2)
+						graph.push_back({ std::min(p1, p2), std::max(p1, p2), edge.isOutside });
+				}
+
+				std::sort(graph.begin(), graph.end(), [](const GraphEdge &a, const GraphEdge &b) {
+					return a.p1 < b.p1 || (a.p1 == b.p1 && a.p2 < b.p2); });
+
+				size_t unique = 0;
+				for (size_t i = 0; i < graph.size(); ++i)
+					if (unique && graph[unique - 1].p1 == graph[i].p1 && graph[unique - 1].p2 == graph[i].p2)
+						graph[unique - 1].isOutside ^= graph[i].isOutside;
+					else
+						graph[unique++] = graph[i];
+				graph.resize(unique);
+
+				return graph;
+			}
+
+			// whether the closed segments ab and cd share any point
+			bool ifDoSegmentsTouch(Vec2 a, Vec2 b, Vec2 c, Vec2 d)
+			{
+				double d1 = orientCoords(a.x, a.y, b.x, b.y, c.x, c.y), d2 = orientCoords(a.x, a.y, b.x, b.y, d.x, d.y);
+				double d3 = orientCoords(c.x, c.y, d.x, d.y, a.x, a.y), d4 = orientCoords(c.x, c.y, d.x, d.y, b.x, b.y);
+				if ((d1 > 0.0 && d2 > 0.0) || (d1 < 0.0 && d2 < 0.0) || (d3 > 0.0 && d4 > 0.0) || (d3 < 0.0 && d4 < 0.0))
+					return false;
+
+				if (d1 != 0.0 || d2 != 0.0 || d3 != 0.0 || d4 != 0.0)
+					return true;
+
+				// all on 1 line, so touching if their ranges along it overlap
+				auto getRange = [](Vec2 p, Vec2 q, bool isX) {
+					return isX ? std::minmax(p.x, q.x) : std::minmax(p.y, q.y); };
+				bool isX = a.x != b.x || c.x != d.x;
+				auto [min1, max1] = getRange(a, b, isX);
+				auto [min2, max2] = getRange(c, d, isX);
+				return min1 <= max2 && min2 <= max1;
+			}
+
+			// whether 2 segments leaving the same point run along each other
+			bool ifDoesOverlap(Vec2 from, Vec2 to1, Vec2 to2)
+			{
+				double dx1 = static_cast<double>(to1.x) - from.x, dy1 = static_cast<double>(to1.y) - from.y;
+				double dx2 = static_cast<double>(to2.x) - from.x, dy2 = static_cast<double>(to2.y) - from.y;
+				return dx1 * dy2 - dy1 * dx2 == 0.0 && dx1 * dx2 + dy1 * dy2 > 0.0;
+			}
+
+			bool ifIsLive(const std::vector<Vertex> &vertices, const Edge &edge)
+			{
+				return edge.type != EdgeType::REMOVED && vertices[edge.p1].type != VertexType::REMOVED &&
+					vertices[edge.p2].type != VertexType::REMOVED;
+			}
+
+			unsigned findRoot(std::vector<unsigned> &parents, unsigned i)
+			{
+				while (parents[i] != i)
+					i = parents[i] = parents[parents[i]];
+				return i;
+			}
+
+			// the face as one circular doubly linked list, holes get spliced in through a pair of bridge edges
+			class EarClipper
+			{
+				struct Node
+				{
+					unsigned vertex;
+					double x, y;
+					unsigned prev, next;
+					bool isReflex = false;
+				};
+
+				std::vector<Node> nodes;
+
+				// reflex vertices bucketed in a grid so an ear only checks the ones under its bounding box
+				// cells may still hold nodes that have since turned convex or been removed
+				std::vector<std::vector<unsigned>> cells;
+				unsigned gridSize = 1;
+				double minX = 0.0, minY = 0.0, cellWidth = 1.0, cellHeight = 1.0;
+
+				double orient(unsigned a, unsigned b, unsigned c) const
+				{
+					return orientCoords(nodes[a].x, nodes[a].y, nodes[b].x, nodes[b].y, nodes[c].x, nodes[c].y);
+				}
+
+				bool ifIsSamePos(unsigned a, unsigned b) const
+				{
+					return nodes[a].x == nodes[b].x && nodes[a].y == nodes[b].y;
+				}
+
+				bool ifIsInTriangle(unsigned a, unsigned b, unsigned c, unsigned p) const
+				{
+					double d1 = orient(a, b, p), d2 = orient(b, c, p), d3 = orient(c, a, p);
+					return !((d1 < 0.0 || d2 < 0.0 || d3 < 0.0) && (d1 > 0.0 || d2 > 0.0 || d3 > 0.0));
+				}
+
+				// whether the diagonal from a to b starts off inside the polygon
+				bool ifIsLocallyInside(unsigned a, unsigned b) const
+				{
+					const Node &node = nodes[a];
+					return orient(node.prev, a, node.next) > 0.0 ?
+						orient(a, b, node.next) <= 0.0 && orient(a, node.prev, b) <= 0.0 :
+						orient(a, b, node.prev) > 0.0 || orient(a, node.next, b) > 0.0;
+				}
+
+				unsigned addLoop(const std::vector<Vertex> &vertices, const std::vector<unsigned> &loop)
+				{
+					unsigned first = static_cast<unsigned>(nodes.size());
+
+					for (size_t i = 0; i < loop.size(); ++i)
+					{
+						Node node;
+						node.vertex = loop[i];
+						node.x = vertices[loop[i]].pos.x;
+						node.y = vertices[loop[i]].pos.y;
+						node.prev = first + static_cast<unsigned>((i + loop.size() - 1) % loop.size());
+						node.next = first + static_cast<unsigned>((i + 1) % loop.size());
+						nodes.push_back(node);
+					}
+
+					return first;
+				}
+
+				unsigned copyNode(unsigned i)
+				{
+					nodes.push_back(nodes[i]);
+					return static_cast<unsigned>(nodes.size() - 1);
+				}
+
+				// links a to b with a new pair of edges, b's loop ends up spliced into a's
+				void split(unsigned a, unsigned b)
+				{
+					unsigned a2 = copyNode(a), b2 = copyNode(b);
+					unsigned an = nodes[a].next, bp = nodes[b].prev;
+
+					nodes[a].next = b;
+					nodes[b].prev = a;
+					nodes[a2].next = an;
+					nodes[an].prev = a2;
+					nodes[b2].next = a2;
+					nodes[a2].prev = b2;
+					nodes[bp].next = b2;
+					nodes[b2].prev = bp;
+				}
+
+				// the outer vertex the hole's rightmost vertex can see, found by casting a ray to the right
+				unsigned findBridge(unsigned hole, unsigned outer) const
+				{
+					double hx = nodes[hole].x, hy = nodes[hole].y;
+					double qx = std::numeric_limits<double>::infinity();
+					unsigned bridge = NONE;
+
+					unsigned p = outer;
+					do
+					{
+						const Node &a = nodes[p], &b = nodes[a.next];
+
+						// edges that run upwards are the right hand walls of a counter clockwise loop
+						if (a.y <= hy && hy <= b.y && a.y != b.y)
+						{
+							double x = a.x + (hy - a.y) * (b.x - a.x) / (b.y - a.y);
+							if (x >= hx && x < qx)
+							{
+								qx = x;
+								bridge = a.x > b.x ? p : a.next;
+							}
+						}
+
+						p = a.next;
+					} while (p != outer);
+
+					if (bridge == NONE || (nodes[bridge].x == qx && nodes[bridge].y == hy))
+						return bridge;
+
+					// a reflex vertex inside the triangle of the hole vertex, the hit and the bridge would block it,
+					// the visible one is the one closest in angle to the ray
+					double mx = nodes[bridge].x, my = nodes[bridge].y;
+					double minTan = std::numeric_limits<double>::infinity();
+					unsigned stop = bridge;
+					p = bridge;
+
+					do
+					{
+						const Node &node = nodes[p];
+						if (node.x > hx && node.x <= mx && p != stop)
+						{
+							double d1 = orientCoords(hx, hy, qx, hy, node.x, node.y);
+							double d2 = orientCoords(qx, hy, mx, my, node.x, node.y);
+							double d3 = orientCoords(mx, my, hx, hy, node.x, node.y);
+							bool isInside = !((d1 < 0.0 || d2 < 0.0 || d3 < 0.0) && (d1 > 0.0 || d2 > 0.0 || d3 > 0.0));
+							double tan = std::abs(hy - node.y) / (node.x - hx);
+
+							if (isInside && ifIsLocallyInside(p, hole) && (tan < minTan || (tan == minTan &&
+								node.x < nodes[bridge].x)))
+							{
+								bridge = p;
+								minTan = tan;
+							}
+						}
+						p = node.next;
+					} while (p != stop);
+
+					return bridge;
+				}
+
+				unsigned getCellX(double x) const
+				{
+					return std::min(static_cast<unsigned>(std::max((x - minX) / cellWidth, 0.0)), gridSize - 1);
+				}
+
+				unsigned getCellY(double y) const
+				{
+					return std::min(static_cast<unsigned>(std::max((y - minY) / cellHeight, 0.0)), gridSize - 1);
+				}
+
+				// roughly one reflex vertex per cell
+				void initGrid(unsigned start, size_t count)
+				{
+					double maxX = nodes[start].x, maxY = nodes[start].y;
+					minX = maxX;
+					minY = maxY;
+					size_t reflexCount = 0;
+
+					unsigned i = start;
+					do
+					{
+						minX = std::min(minX, nodes[i].x);
+						minY = std::min(minY, nodes[i].y);
+						maxX = std::max(maxX, nodes[i].x);
+						maxY = std::max(maxY, nodes[i].y);
+						reflexCount += orient(nodes[i].prev, i, nodes[i].next) <= 0.0;
+						i = nodes[i].next;
+					} while (i != start);
+
+					gridSize = std::clamp(static_cast<unsigned>(std::sqrt(static_cast<double>(reflexCount))), 1u, 
+						static_cast<unsigned>(std::sqrt(static_cast<double>(count))) + 1u);
+					cellWidth = std::max((maxX - minX) / gridSize, std::numeric_limits<double>::min());
+					cellHeight = std::max((maxY - minY) / gridSize, std::numeric_limits<double>::min());
+					cells.assign(gridSize * gridSize, {});
+				}
+
+				void updateReflex(unsigned i)
+				{
+					Node &node = nodes[i];
+					bool isReflex = orient(node.prev, i, node.next) <= 0.0;
+
+					if (isReflex && !node.isReflex)
+						cells[getCellY(node.y) * gridSize + getCellX(node.x)].push_back(i);
+
+					node.isReflex = isReflex;
+				}
+
+				// also drops nodes from the cells it scans that are no longer reflex
+				bool ifIsEar(unsigned i)
+				{
+					const Node &node = nodes[i];
+					unsigned a = node.prev, c = node.next;
+
+					if (node.isReflex)
+						return false;
+
+					unsigned x0 = getCellX(std::min({ nodes[a].x, node.x, nodes[c].x }));
+					unsigned x1 = getCellX(std::max({ nodes[a].x, node.x, nodes[c].x }));
+					unsigned y0 = getCellY(std::min({ nodes[a].y, node.y, nodes[c].y }));
+					unsigned y1 = getCellY(std::max({ nodes[a].y, node.y, nodes[c].y }));
+
+					for (unsigned y = y0; y <= y1; ++y)
+						for (unsigned x = x0; x <= x1; ++x)
+						{
+							std::vector<unsigned> &cell = cells[y * gridSize + x];
+							for (size_t j = 0; j < cell.size(); )
+							{
+								unsigned p = cell[j];
+								if (!nodes[p].isReflex)
+								{
+									cell[j] = cell.back();
+									cell.pop_back();
+									continue;
+								}
+
+								if (p != a && p != i && p != c && !ifIsSamePos(p, a) && !ifIsSamePos(p, i) &&
+									!ifIsSamePos(p, c) && ifIsInTriangle(a, i, c, p))
+									return false;
+								++j;
+							}
+						}
+
+					return true;
+				}
+
+				void remove(unsigned i)
+				{
+					Node &node = nodes[i];
+					nodes[node.prev].next = node.next;
+					nodes[node.next].prev = node.prev;
+					node.isReflex = false;
+				}
+
+				void addTriangle(unsigned a, unsigned b, unsigned c, std::vector<Triangle> &triangles) const
+				{
+					if (orient(a, b, c) == 0.0)
+						return; // nothing to fill
+
+					std::array<unsigned, 3> points{ nodes[a].vertex, nodes[b].vertex, nodes[c].vertex };
+					std::sort(points.begin(), points.end());
+					triangles.emplace_back(points[0], points[1], points[2]);
+				}
+
+			public:
+
+				void clip(const std::vector<Vertex> &vertices, const Face &face, std::vector<Triangle> &triangles)
+				{
+					if (face.outer.size() < 3)
+						return;
+
+					unsigned outer = addLoop(vertices, face.outer);
+
+					// bridge holes from right to left so a bridge never has to cross a hole that isn't in yet
+					std::vector<unsigned> holes;
+					for (const std::vector<unsigned> &loop : face.holes)
+						if (loop.size() >= 3)
+						{
+							unsigned first = addLoop(vertices, loop), rightmost = first;
+							for (unsigned i = first; i < nodes.size(); ++i)
+								if (nodes[i].x > nodes[rightmost].x ||
+									(nodes[i].x == nodes[rightmost].x && nodes[i].y < nodes[rightmost].y))
+									rightmost = i;
+							holes.push_back(rightmost);
+						}
+
+					std::sort(holes.begin(), holes.end(), [this](unsigned a, unsigned b) {
+						return nodes[a].x > nodes[b].x; });
+
+					for (unsigned hole : holes)
+					{
+						unsigned bridge = findBridge(hole, outer);
+						if (bridge != NONE)
+							split(bridge, hole);
+					}
+
+					size_t count = 0;
+					for (unsigned i = outer; !count || i != outer; i = nodes[i].next)
+						++count;
+
+					initGrid(outer, count);
+					for (unsigned i = outer, j = 0; j < count; i = nodes[i].next, ++j)
+						updateReflex(i);
+
+					unsigned ear = outer, stop = outer;
+					while (count > 3)
+					{
+						unsigned prev = nodes[ear].prev, next = nodes[ear].next;
+
+						if (ifIsEar(ear))
+						{
+							addTriangle(prev, ear, next, triangles);
+							remove(ear);
+							--count;
+							updateReflex(prev);
+							updateReflex(next);
+							ear = stop = next;
+							continue;
+						}
+
+						ear = next;
+						if (ear != stop)
+							continue;
+
+						// went all the way round without an ear, so drop a point that adds no area or, failing that,
+						// clip a vertex anyway since the input has to be degenerate to get here
+						unsigned toDrop = ear;
+						for (unsigned i = nodes[ear].next; i != ear; i = nodes[i].next)
+							if (ifIsSamePos(i, nodes[i].next) || orient(nodes[i].prev, i, nodes[i].next) == 0.0)
+							{
+								toDrop = i;
+								break;
+							}
+
+						prev = nodes[toDrop].prev;
+						next = nodes[toDrop].next;
+						if (!ifIsSamePos(toDrop, next) && orient(prev, toDrop, next) > 0.0)
+							addTriangle(prev, toDrop, next, triangles);
+						remove(toDrop);
+						--count;
+						updateReflex(prev);
+						updateReflex(next);
+						ear = stop = next;
+					}
+
+					unsigned last = ear;
+					if (count == 3 && orient(nodes[last].prev, last, nodes[last].next) > 0.0)
+						addTriangle(nodes[last].prev, last, nodes[last].next, triangles);
+				}
+			};
+
+			/*! ------------ Robust predicates ------------ */
+
+			// shewchuk's error bounds, results outside them are certain to have the right sign
+
+			// when the fast result is too close to call, the rounding errors of both products and their difference are
+			// recovered exactly with fma and two sum and added back in
+			double orientRobust(double ax, double ay, double bx, double by, double cx, double cy)
+			{
+				double acx = ax - cx, bcy = by - cy, acy = ay - cy, bcx = bx - cx;
+				double left = acx * bcy, right = acy * bcx;
+				double det = left - right;
+
+				if (std::abs(det) > 3.3306690738754716e-16 * (std::abs(left) + std::abs(right)))
+					return det;
+
+				double virtualRight = left - det;
+				double detError = (left - (det + virtualRight)) + (virtualRight - right);
+				return det + (detError + std::fma(acx, bcy, -left) - std::fma(acy, bcx, -right));
+			}
+
+			// positive when d is inside the circle through the counter clockwise abc
+			// too close to call counts as on the circle, which only ever costs a flip and never validity
+			double inCircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy)
+			{
+				double adx = ax - dx, ady = ay - dy, bdx = bx - dx, bdy = by - dy, cdx = cx - dx, cdy = cy - dy;
+				double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy, cdxady = cdx * ady;
+				double adxcdy = adx * cdy, adxbdy = adx * bdy, bdxady = bdx * ady;
+				double aLift = adx * adx + ady * ady, bLift = bdx * bdx + bdy * bdy, cLift = cdx * cdx + cdy * cdy;
+
+				double det = aLift * (bdxcdy - cdxbdy) + bLift * (cdxady - adxcdy) + cLift * (adxbdy - bdxady);
+				double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * aLift +
+					(std::abs(cdxady) + std::abs(adxcdy)) * bLift + (std::abs(adxbdy) + std::abs(bdxady)) * cLift;
+
+				return std::abs(det) > 1.1102230246251577e-15 * permanent ? det : 0.0;
+			}
+
+			/*! ------------ Constrained delaunay ------------ */
+
+			// points are inserted one by one inside a super triangle and flipped until delaunay (lawson), then each
+			// constraint is forced in by flipping away the edges crossing it (sloan) and faces are filled by flood
+			// filling the even odd rule across outside constraints
+			class DelaunayTriangulator
+			{
+				// corners are counter clockwise, neighbours[i] is across the edge opposite corners[i]
+				struct Tri
+				{
+					std::array<unsigned, 3> corners;
+					std::array<unsigned, 3> neighbours;
+				};
+
+				std::vector<double> xs, ys;
+				std::vector<unsigned> toVertex; // point to the shape vertex it came from
+				std::vector<unsigned> pointTri; // a triangle touching each point
+				std::vector<Tri> tris;
+				std::unordered_map<uint64_t, bool> constraints; // to isOutside
+				unsigned superPoint = 0; // first of the super triangle's 3 points
+				unsigned walkCount = 0;
+
+				static uint64_t getKey(unsigned p1, unsigned p2)
+				{
+					return static_cast<uint64_t>(std::min(p1, p2)) << 32 | std::max(p1, p2);
+				}
+
+				static unsigned next(unsigned i)
+				{
+					return i == 2 ? 0 : i + 1;
+				}
+
+				static unsigned prev(unsigned i)
+				{
+					return i == 0 ? 2 : i - 1;
+				}
+
+				double orient(unsigned a, unsigned b, unsigned c) const
+				{
+					return orientRobust(xs[a], ys[a], xs[b], ys[b], xs[c], ys[c]);
+				}
+
+				// whether d is far enough inside the triangle's circumcircle that the edge facing it should flip
+				bool ifShldFlip(const Tri &tri, unsigned d) const
+				{
+					unsigned a = tri.corners[0], b = tri.corners[1], c = tri.corners[2];
+					return inCircle(xs[a], ys[a], xs[b], ys[b], xs[c], ys[c], xs[d], ys[d]) > 0.0;
+				}
+
+				unsigned findCorner(const Tri &tri, unsigned point) const
+				{
+					for (unsigned i = 0; i < 3; ++i)
+						if (tri.corners[i] == point)
+							return i;
+					return NONE;
+				}
+
+				void setTri(unsigned t, unsigned a, unsigned b, unsigned c, unsigned na, unsigned nb, unsigned nc)
+				{
+					tris[t] = { { a, b, c }, { na, nb, nc } };
+					pointTri[a] = pointTri[b] = pointTri[c] = t;
+				}
+
+				unsigned addTri()
+				{
+					tris.emplace_back();
+					return static_cast<unsigned>(tris.size() - 1);
+				}
+
+				void replaceNeighbour(unsigned t, unsigned from, unsigned to)
+				{
+					if (t == NONE)
+						return;
+
+					for (unsigned &neighbour : tris[t].neighbours)
+						if (neighbour == from)
+						{
+							neighbour = to;
+							return;
+						}
+				}
+
+				// turns the edge opposite corner i of t and its neighbour into the quad's other diagonal
+				// t keeps corner a and the neighbour keeps corner d
+				void flip(unsigned t, unsigned i)
+				{
+					Tri tri = tris[t];
+					unsigned u = tri.neighbours[i];
+					Tri other = tris[u];
+					unsigned j = 0;
+					while (other.neighbours[j] != t)
+						++j;
+
+					unsigned a = tri.corners[i], b = tri.corners[next(i)], c = tri.corners[prev(i)];
+					unsigned d = other.corners[j];
+					unsigned nCA = tri.neighbours[next(i)], nAB = tri.neighbours[prev(i)];
+					unsigned nBD = other.neighbours[next(j)], nDC = other.neighbours[prev(j)];
+
+					setTri(t, a, b, d, nBD, u, nAB);
+					setTri(u, a, d, c, nDC, nCA, t);
+					replaceNeighbour(nBD, u, t);
+					replaceNeighbour(nCA, t, u);
+				}
+
+				// flips the edges opposite the new point until every triangle around it is delaunay again
+				void legalise(std::vector<std::pair<unsigned, unsigned>> &toCheck)
+				{
+					while (!toCheck.empty())
+					{
+						auto [t, i] = toCheck.back();
+						toCheck.pop_back();
+
+						unsigned u = tris[t].neighbours[i];
+						if (u == NONE)
+							continue;
+
+						unsigned j = 0;
+						while (tris[u].neighbours[j] != t)
+							++j;
+
+						if (ifShldFlip(tris[t], tris[u].corners[j]))
+						{
+							flip(t, i);
+							toCheck.push_back({ t, 0 });
+							toCheck.push_back({ u, 0 });
+						}
+					}
+				}
+
+				// visibility walk, which edge is tried first rotates so it can't cycle forever
+				unsigned locate(unsigned point, unsigned t)
+				{
+					for (bool hasMoved = true; hasMoved; )
+					{
+						hasMoved = false;
+						unsigned first = walkCount++ % 3;
+
+						for (unsigned k = 0; k < 3; ++k)
+						{
+							unsigned i = (first + k) % 3;
+							const Tri &tri = tris[t];
+							if (orient(tri.corners[next(i)], tri.corners[prev(i)], point) < 0.0 && tri.neighbours[i] != NONE)
+							{
+								t = tri.neighbours[i];
+								hasMoved = true;
+								break;
+							}
+						}
+					}
+
+					return t;
+				}
+
+				void insert(unsigned p, unsigned t)
+				{
+					Tri tri = tris[t];
+					std::vector<std::pair<unsigned, unsigned>> toCheck;
+
+					unsigned onEdge = NONE;
+					for (unsigned i = 0; i < 3; ++i)
+						if (orient(tri.corners[next(i)], tri.corners[prev(i)], p) == 0.0)
+							onEdge = i;
+
+					if (onEdge == NONE)
+					{
+						// split into 3 round the point
+						unsigned a = tri.corners[0], b = tri.corners[1], c = tri.corners[2];
+						unsigned t1 = addTri(), t2 = addTri();
+
+						setTri(t, p, b, c, tri.neighbours[0], t1, t2);
+						setTri(t1, p, c, a, tri.neighbours[1], t2, t);
+						setTri(t2, p, a, b, tri.neighbours[2], t, t1);
+						replaceNeighbour(tri.neighbours[1], t, t1);
+						replaceNeighbour(tri.neighbours[2], t, t2);
+
+						toCheck = { { t, 0 }, { t1, 0 }, { t2, 0 } };
+					}
+					else
+					{
+						// split both triangles sharing the edge the point is on into 2
+						unsigned i = onEdge, u = tri.neighbours[i];
+						Tri other = tris[u];
+						unsigned j = 0;
+						while (other.neighbours[j] != t)
+							++j;
+
+						unsigned a = tri.corners[i], b = tri.corners[next(i)], c = tri.corners[prev(i)];
+						unsigned d = other.corners[j];
+						unsigned nCA = tri.neighbours[next(i)], nAB = tri.neighbours[prev(i)];
+						unsigned nBD = other.neighbours[next(j)], nDC = other.neighbours[prev(j)];
+						unsigned t2 = addTri(), u2 = addTri();
+
+						setTri(t, p, a, b, nAB, u, t2);
+						setTri(t2, p, c, a, nCA, t, u2);
+						setTri(u, p, b, d, nBD, u2, t);
+						setTri(u2, p, d, c, nDC, t2, u);
+						replaceNeighbour(nCA, t, t2);
+						replaceNeighbour(nDC, u, u2);
+
+						toCheck = { { t, 0 }, { t2, 0 }, { u, 0 }, { u2, 0 } };
+					}
+
+					legalise(toCheck);
+				}
+
+				// the triangle with from and to as consecutive counter clockwise corners, and the corner opposite it
+				// the triangles round a super point don't close into a ring, so the walk turns back at the hull
+				std::pair<unsigned, unsigned> findEdge(unsigned from, unsigned to) const
+				{
+					for (bool isClockwise : { true, false })
+					{
+						unsigned start = pointTri[from], t = start;
+						do
+						{
+							unsigned k = findCorner(tris[t], from);
+							if (tris[t].corners[next(k)] == to)
+								return { t, prev(k) };
+							t = tris[t].neighbours[isClockwise ? prev(k) : next(k)];
+						} while (t != NONE && t != start);
+
+						if (t == start)
+							break;
+					}
+
+					return { NONE, NONE };
+				}
+
+				// either triangle on the edge between p1 and p2, and the corner opposite it
+				std::pair<unsigned, unsigned> findAnyEdge(unsigned p1, unsigned p2) const
+				{
+					std::pair<unsigned, unsigned> edge = findEdge(p1, p2);
+					return edge.first != NONE ? edge : findEdge(p2, p1);
+				}
+
+				bool ifHasEdge(unsigned p1, unsigned p2) const
+				{
+					return findAnyEdge(p1, p2).first != NONE;
+				}
+
+				// whether p lies strictly inside the segment from a to b, given that it's on its line
+				bool ifIsBetween(unsigned a, unsigned b, unsigned p) const
+				{
+					double dx = xs[b] - xs[a], dy = ys[b] - ys[a];
+					double t = (xs[p] - xs[a]) * dx + (ys[p] - ys[a]) * dy;
+					return t > 0.0 && t < dx * dx + dy * dy;
+				}
+
+				void splitConstraint(unsigned a, unsigned b, unsigned p, std::vector<std::pair<unsigned, unsigned>> &toAdd)
+				{
+					bool isOutside = constraints[getKey(a, b)];
+					constraints.erase(getKey(a, b));
+					constraints[getKey(a, p)] ^= isOutside;
+					constraints[getKey(p, b)] ^= isOutside;
+					toAdd.push_back({ a, p });
+					toAdd.push_back({ p, b });
+				}
+
+				// walks from a to b collecting the edges crossing it as (left, right) of a to b
+				// returns false if the constraint had to be split at a point lying on it
+				bool findCrossings(unsigned a, unsigned b, std::vector<std::pair<unsigned, unsigned>> &crossings,
+					std::vector<std::pair<unsigned, unsigned>> &toAdd)
+				{
+					// find the triangle round a that the segment leaves through
+					unsigned start = pointTri[a], t = start, left = NONE, right = NONE;
+					do
+					{
+						unsigned k = findCorner(tris[t], a);
+						unsigned p = tris[t].corners[next(k)], q = tris[t].corners[prev(k)];
+
+						for (unsigned x : { p, q })
+							if (orient(a, b, x) == 0.0 && ifIsBetween(a, b, x))
+							{
+								splitConstraint(a, b, x, toAdd);
+								return false;
+							}
+
+						if (orient(a, b, p) < 0.0 && orient(a, b, q) > 0.0)
+						{
+							left = q;
+							right = p;
+							t = tris[t].neighbours[k];
+							break;
+						}
+
+						t = tris[t].neighbours[prev(k)];
+					} while (t != NONE && t != start);
+
+					crashIf(left == NONE, "Constraint does not leave its first point");
+
+					for (crossings.push_back({ left, right }); ; )
+					{
+						const Tri &tri = tris[t];
+						unsigned r = tri.corners[0] + tri.corners[1] + tri.corners[2] - left - right;
+						if (r == b)
+							return true;
+
+						double side = orient(a, b, r);
+						if (side == 0.0)
+						{
+							splitConstraint(a, b, r, toAdd);
+							return false;
+						}
+
+						// step into the triangle across whichever of the 2 new edges the segment crosses
+						if (side > 0.0)
+						{
+							t = tri.neighbours[findCorner(tri, left)];
+							left = r;
+						}
+						else
+						{
+							t = tri.neighbours[findCorner(tri, right)];
+							right = r;
+						}
+						crossings.push_back({ left, right });
+					}
+				}
+
+				// returns false if the edges crossing the constraint couldn't all be flipped away
+				bool addConstraint(unsigned a, unsigned b, std::vector<std::pair<unsigned, unsigned>> &toAdd)
+				{
+					if (ifHasEdge(a, b))
+						return true;
+
+					std::vector<std::pair<unsigned, unsigned>> crossings;
+					if (!findCrossings(a, b, crossings, toAdd))
+						return true;
+
+					std::deque<std::pair<unsigned, unsigned>> toFlip(crossings.begin(), crossings.end());
+					std::vector<std::pair<unsigned, unsigned>> newEdges;
+
+					// sloan's flips always finish for exact predicates, the limit only catches rounding going wrong
+					for (size_t flipsLeft = toFlip.size() * toFlip.size() * 4 + BIG; !toFlip.empty(); --flipsLeft)
+					{
+						if (!flipsLeft)
+							return false;
+
+						auto [p, q] = toFlip.front();
+						toFlip.pop_front();
+
+						auto [t, i] = findAnyEdge(p, q);
+						crashIf(t == NONE, "Could not find an edge crossing a constraint");
+
+						unsigned u = tris[t].neighbours[i];
+						unsigned j = 0;
+						while (tris[u].neighbours[j] != t)
+							++j;
+
+						// the quad x p y q has to be strictly convex to flip, otherwise try again once its neighbours
+						// have moved
+						unsigned x = tris[t].corners[i], y = tris[u].corners[j];
+						unsigned p1 = tris[t].corners[next(i)], p2 = tris[t].corners[prev(i)];
+						if (orient(x, p1, y) <= 0.0 || orient(y, p2, x) <= 0.0)
+						{
+							toFlip.push_back({ p, q });
+							continue;
+						}
+
+						flip(t, i);
+
+						if (x != a && x != b && y != a && y != b && orient(a, b, x) * orient(a, b, y) < 0.0)
+							toFlip.push_back({ x, y });
+						else
+							newEdges.push_back({ x, y });
+					}
+
+					// flip the new edges back towards delaunay wherever the constraint allows, stopping early only costs
+					// some delaunay-ness
+					size_t passesLeft = newEdges.size() + SMALL;
+					for (bool hasFlipped = true; hasFlipped && passesLeft; --passesLeft)
+					{
+						hasFlipped = false;
+
+						for (std::pair<unsigned, unsigned> &edge : newEdges)
+						{
+							if (constraints.count(getKey(edge.first, edge.second)))
+								continue;
+
+							auto [t, i] = findEdge(edge.first, edge.second);
+							if (t == NONE)
+								continue;
+
+							unsigned u = tris[t].neighbours[i];
+							unsigned j = 0;
+							while (tris[u].neighbours[j] != t)
+								++j;
+
+							if (ifShldFlip(tris[t], tris[u].corners[j]))
+							{
+								edge = { tris[t].corners[i], tris[u].corners[j] };
+								flip(t, i);
+								hasFlipped = true;
+							}
+						}
+					}
+
+					return true;
+				}
+
+			public:
+
+				// returns false if a constraint couldn't be recovered, in which case nothing is added to triangles
+				bool triangulate(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges,
+					std::vector<Triangle> &triangles)
+				{
+					std::vector<GraphEdge> graph = collectEdges(vertices, edges);
+					if (graph.empty())
+						return true;
+
+					/*! ------------ Points ------------ */
+
+					// only points on edges take part, collectEdges has already merged points in the same place
+					std::vector<unsigned> used;
+					for (const GraphEdge &edge : graph)
+					{
+						used.push_back(edge.p1);
+						used.push_back(edge.p2);
+					}
+					std::sort(used.begin(), used.end(), [&vertices](unsigned a, unsigned b) {
+						return vertices[a].pos.x < vertices[b].pos.x ||
+							(vertices[a].pos.x == vertices[b].pos.x && vertices[a].pos.y < vertices[b].pos.y); });
+
+					std::unordered_map<unsigned, unsigned> toPoint;
+					for (unsigned vertex : used)
+					{
+						if (toPoint.count(vertex))
+							continue;
+
+						toPoint[vertex] = static_cast<unsigned>(toVertex.size());
+						toVertex.push_back(vertex);
+						xs.push_back(vertices[vertex].pos.x);
+						ys.push_back(vertices[vertex].pos.y);
+					}
+
+					// super triangle well clear of every point
+					double minX = *std::min_element(xs.begin(), xs.end()), maxX = *std::max_element(xs.begin(), xs.end());
+					double minY = *std::min_element(ys.begin(), ys.end()), maxY = *std::max_element(ys.begin(), ys.end());
+					double size = std::max({ maxX - minX, maxY - minY, 1.0 }) * 20.0;
+					double midX = (minX + maxX) / 2.0, midY = (minY + maxY) / 2.0;
+
+					superPoint = static_cast<unsigned>(xs.size());
+					xs.insert(xs.end(), { midX - size, midX + size, midX });
+					ys.insert(ys.end(), { midY - size, midY - size, midY + size });
+					pointTri.assign(xs.size(), NONE);
+
+					tris.reserve(xs.size() * 2);
+					setTri(addTri(), superPoint, superPoint + 1, superPoint + 2, NONE, NONE, NONE);
+
+					/*! ------------ Delaunay ------------ */
+
+					// insert in snaking rows of a grid so each walk starts near its point
+					std::vector<unsigned> order(superPoint);
+					std::iota(order.begin(), order.end(), 0u);
+					unsigned rows = static_cast<unsigned>(std::sqrt(static_cast<double>(superPoint) / 4.0)) + 1;
+					double rowHeight = (maxY - minY) / rows + std::numeric_limits<double>::min();
+
+					auto getRow = [&](unsigned p) { return std::min(static_cast<unsigned>((ys[p] - minY) / rowHeight),
+						rows - 1); };
+					std::sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+						unsigned rowA = getRow(a), rowB = getRow(b);
+						if (rowA != rowB)
+							return rowA < rowB;
+						return rowA % 2 ? xs[a] > xs[b] : xs[a] < xs[b]; });
+
+					unsigned last = 0;
+					for (unsigned p : order)
+					{
+						last = locate(p, last);
+						insert(p, last);
+						last = pointTri[p];
+					}
+
+					/*! ------------ Constraints ------------ */
+
+					std::vector<std::pair<unsigned, unsigned>> toAdd;
+					for (const GraphEdge &edge : graph)
+					{
+						unsigned a = toPoint[edge.p1], b = toPoint[edge.p2];
+						constraints[getKey(a, b)] ^= edge.isOutside;
+						toAdd.push_back({ a, b });
+					}
+
+					while (!toAdd.empty())
+					{
+						auto [a, b] = toAdd.back();
+						toAdd.pop_back();
+						if (!addConstraint(a, b, toAdd))
+							return false;
+					}
+
+					/*! ------------ Even odd fill ------------ */
+
+					// the super triangle's corners are outside, and crossing an outside constraint flips
+					std::vector<int> parities(tris.size(), -1);
+					std::vector<unsigned> toVisit = { pointTri[superPoint] };
+					parities[toVisit.back()] = 0;
+
+					while (!toVisit.empty())
+					{
+						unsigned t = toVisit.back();
+						toVisit.pop_back();
+
+						for (unsigned i = 0; i < 3; ++i)
+						{
+							unsigned u = tris[t].neighbours[i];
+							if (u == NONE || parities[u] != -1)
+								continue;
+
+							auto constraint = constraints.find(getKey(tris[t].corners[next(i)], tris[t].corners[prev(i)]));
+							parities[u] = parities[t] ^ (constraint != constraints.end() && constraint->second);
+							toVisit.push_back(u);
+						}
+					}
+
+					for (unsigned t = 0; t < tris.size(); ++t)
+					{
+						const std::array<unsigned, 3> &c = tris[t].corners;
+						if (parities[t] != 1 || c[0] >= superPoint || c[1] >= superPoint || c[2] >= superPoint)
+							continue;
+
+						std::array<unsigned, 3> points{ toVertex[c[0]], toVertex[c[1]], toVertex[c[2]] };
+						std::sort(points.begin(), points.end());
+						triangles.emplace_back(points[0], points[1], points[2]);
+					}
+
+					return true;
+				}
+			};
+
+			/*! ------------ Sweep line intersections ------------ */
+
+			// bentley ottmann, a vertical line sweeps left to right keeping the edges it crosses sorted bottom to top,
+			// so only edges that become neighbours there can cross next and every crossing costs O(log n)
+			class SweepLine
+			{
+			public:
+
+				struct Crossing
+				{
+					unsigned edge1, edge2; // edge2 is NONE where an endpoint touches edge1
+					double x, y;
+				};
+
+			private:
+
+				enum class EventType
+				{
+					CROSS,
+					REMOVE,
+					INSERT,
+					MAX_EVENT_TYPES
+				};
+
+				struct Event
+				{
+					double x, y;
+					EventType type;
+					unsigned segment, other; // other is only for crossings, where segment is below
+
+					bool operator>(const Event &that) const
+					{
+						if (x != that.x)
+							return x > that.x;
+						if (y != that.y)
+							return y > that.y;
+						return type > that.type;
+					}
+				};
+
+				// endpoints sorted left to right, then bottom to top for vertical ones
+				struct Segment
+				{
+					double x1, y1, x2, y2;
+					unsigned edge;
+				};
+
+				// crossings swap the segments of 2 neighbouring entries rather than reinserting them, so the tree never
+				// has to compare segments whose order is about to change
+				struct StatusEntry
+				{
+					mutable unsigned segment;
+				};
+
+				struct StatusOrder
+				{
+					const SweepLine *sweep;
+
+					bool operator()(const StatusEntry &a, const StatusEntry &b) const
+					{
+						return sweep->ifIsBelow(a.segment, b.segment);
+					}
+				};
+
+				using Status = std::set<StatusEntry, StatusOrder>;
+
+				std::vector<Segment> segments;
+				std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events;
+				Status status{ StatusOrder{ this } };
+				std::vector<Status::iterator> entries; // of each segment while it's in status
+				std::unordered_set<uint64_t> crossed; // pairs already swapped, as a segment can only cross another once
+				double sweepX = 0.0, sweepY = 0.0;
+
+				double getY(unsigned s) const
+				{
+					const Segment &seg = segments[s];
+					if (seg.x1 == seg.x2)
+						return std::clamp(sweepY, seg.y1, seg.y2);
+					if (sweepX == seg.x1)
+						return seg.y1;
+					if (sweepX == seg.x2)
+						return seg.y2;
+					return seg.y1 + (sweepX - seg.x1) * (seg.y2 - seg.y1) / (seg.x2 - seg.x1);
+				}
+
+				// below at the sweep line, or just to its right when they meet on it
+				bool ifIsBelow(unsigned a, unsigned b) const
+				{
+					double yA = getY(a), yB = getY(b);
+					if (yA != yB)
+						return yA < yB;
+
+					const Segment &segA = segments[a], &segB = segments[b];
+					double slopeA = (segA.y2 - segA.y1) * (segB.x2 - segB.x1);
+					double slopeB = (segB.y2 - segB.y1) * (segA.x2 - segA.x1);
+					return slopeA != slopeB ? slopeA < slopeB : a < b;
+				}
+
+				static uint64_t getKey(unsigned a, unsigned b)
+				{
+					return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+				}
+
+				// queues a crossing of neighbouring entries if their interiors cross, touching at a point doesn't count
+				void checkCrossing(Status::iterator below, Status::iterator above)
+				{
+					if (below == status.end() || above == status.end())
+						return;
+
+					unsigned a = below->segment, b = above->segment;
+					if (crossed.count(getKey(a, b)))
+						return;
+
+					const Segment &segA = segments[a], &segB = segments[b];
+					double d1 = orientRobust(segA.x1, segA.y1, segA.x2, segA.y2, segB.x1, segB.y1);
+					double d2 = orientRobust(segA.x1, segA.y1, segA.x2, segA.y2, segB.x2, segB.y2);
+					double d3 = orientRobust(segB.x1, segB.y1, segB.x2, segB.y2, segA.x1, segA.y1);
+					double d4 = orientRobust(segB.x1, segB.y1, segB.x2, segB.y2, segA.x2, segA.y2);
+					if (!((d1 < 0.0 && d2 > 0.0) || (d1 > 0.0 && d2 < 0.0)) || !((d3 < 0.0 && d4 > 0.0) || (d3 > 0.0 && d4 < 0.0)))
+						return;
+
+					double t = d3 / (d3 - d4);
+					double x = segA.x1 + t * (segA.x2 - segA.x1), y = segA.y1 + t * (segA.y2 - segA.y1);
+
+					// rounding can put it just behind the sweep line, but they still have to be swapped
+					if (x < sweepX || (x == sweepX && y < sweepY))
+					{
+						x = sweepX;
+						y = sweepY;
+					}
+					events.push({ x, y, EventType::CROSS, a, b });
+				}
+
+				// an endpoint lying inside other edges splits them too, those edges are on its line and so are found
+				// right around its entry
+				void checkTouches(Status::iterator entry, std::vector<Crossing> &crossings)
+				{
+					auto checkTouch = [this, &crossings](unsigned s) {
+						const Segment &seg = segments[s];
+						if (orientRobust(seg.x1, seg.y1, seg.x2, seg.y2, sweepX, sweepY) != 0.0)
+							return false;
+
+						if ((seg.x1 < sweepX || (seg.x1 == sweepX && seg.y1 < sweepY)) &&
+							(sweepX < seg.x2 || (sweepX == seg.x2 && sweepY < seg.y2)))
+							crossings.push_back({ seg.edge, NONE, sweepX, sweepY });
+						return true;
+					};
+
+					for (Status::iterator below = entry; below != status.begin() && checkTouch(std::prev(below)->segment); )
+						--below;
+					for (Status::iterator above = std::next(entry); above != status.end() && checkTouch(above->segment); )
+						++above;
+				}
+
+			public:
+
+				std::vector<Crossing> findCrossings(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges)
+				{
+					for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
+					{
+						const Edge &edge = edges[i];
+						if (edge.type == EdgeType::REMOVED || vertices[edge.p1].type == VertexType::REMOVED ||
+							vertices[edge.p2].type == VertexType::REMOVED)
+							continue;
+
+						Vec2 p1 = vertices[edge.p1].pos, p2 = vertices[edge.p2].pos;
+						if (p1 == p2)
+							continue;
+						if (p2.x < p1.x || (p2.x == p1.x && p2.y < p1.y))
+							std::swap(p1, p2);
+
+						unsigned s = static_cast<unsigned>(segments.size());
+						segments.push_back({ p1.x, p1.y, p2.x, p2.y, i });
+						events.push({ p1.x, p1.y, EventType::INSERT, s, s });
+						events.push({ p2.x, p2.y, EventType::REMOVE, s, s });
+					}
+					entries.assign(segments.size(), status.end());
+
+					std::vector<Crossing> crossings;
+					while (!events.empty())
+					{
+						Event event = events.top();
+						events.pop();
+						sweepX = event.x;
+						sweepY = event.y;
+
+						if (event.type == EventType::INSERT)
+						{
+							Status::iterator entry = status.insert({ event.segment }).first;
+							entries[event.segment] = entry;
+
+							checkTouches(entry, crossings);
+							checkCrossing(entry == status.begin() ? status.end() : std::prev(entry), entry);
+							checkCrossing(entry, std::next(entry));
+						}
+						else if (event.type == EventType::REMOVE)
+						{
+							Status::iterator entry = entries[event.segment];
+							checkTouches(entry, crossings);
+
+							Status::iterator above = status.erase(entry);
+							entries[event.segment] = status.end();
+
+							if (above != status.begin())
+								checkCrossing(std::prev(above), above);
+						}
+						else
+						{
+							// stale if something has come between them since, they'll be queued again once it's gone
+							Status::iterator below = entries[event.segment], above = entries[event.other];
+							if (below == status.end() || above == status.end() || std::next(below) != above ||
+								!crossed.insert(getKey(event.segment, event.other)).second)
+								continue;
+
+							below->segment = event.other;
+							above->segment = event.segment;
+							entries[event.other] = below;
+							entries[event.segment] = above;
+							crossings.push_back({ segments[event.segment].edge, segments[event.other].edge, event.x, event.y });
+
+							checkCrossing(below == status.begin() ? status.end() : std::prev(below), below);
+							checkCrossing(above, std::next(above));
+						}
+					}
+
+					return crossings;
+				}
+			};
+
+			// vertices bucketed by position so a new one can reuse any within the tolerance in O(1)
+			class VertexHash
+			{
+				std::unordered_map<uint64_t, std::vector<unsigned>> cells;
+				double cellSize = 1.0;
+
+				uint64_t getKey(int64_t cellX, int64_t cellY) const
+				{
+					return static_cast<uint64_t>(cellX) << 32 ^ static_cast<uint32_t>(cellY);
+				}
+
+				int64_t getCell(double coord) const
+				{
+					return static_cast<int64_t>(std::floor(coord / cellSize));
+				}
+
+			public:
+
+				VertexHash(double tolerance) : cellSize(tolerance > 0.0 ? tolerance : 1.0)
+				{
+
+				}
+
+				void add(const std::vector<Vertex> &vertices, unsigned i)
+				{
+					cells[getKey(getCell(vertices[i].pos.x), getCell(vertices[i].pos.y))].push_back(i);
+				}
+
+				// a vertex within the tolerance of pos, or a new added one
+				unsigned findOrAdd(std::vector<Vertex> &vertices, Vec2 pos)
+				{
+					int64_t cellX = getCell(pos.x), cellY = getCell(pos.y);
+					double toleranceSq = cellSize * cellSize;
+
+					for (int64_t x = cellX - 1; x <= cellX + 1; ++x)
+						for (int64_t y = cellY - 1; y <= cellY + 1; ++y)
+						{
+							auto cell = cells.find(getKey(x, y));
+							if (cell == cells.end())
+								continue;
+
+							for (unsigned i : cell->second)
+							{
+								double dx = static_cast<double>(vertices[i].pos.x) - pos.x;
+								double dy = static_cast<double>(vertices[i].pos.y) - pos.y;
+								if (dx * dx + dy * dy <= toleranceSq)
+									return i;
+							}
+						}
+
+					vertices.emplace_back(pos, VertexType::ADDED);
+					unsigned i = static_cast<unsigned>(vertices.size() - 1);
+					cells[getKey(cellX, cellY)].push_back(i);
+					return i;
+				}
+			};
+		}
+
+		double orient(Vec2 a, Vec2 b, Vec2 c)
+		{
+			return orientCoords(a.x, a.y, b.x, b.y, c.x, c.y);
+		}
+
+		bool ifIsInPolygon(Vec2 point, const std::vector<Vertex> &vertices, const std::vector<unsigned> &loop)
+		{
+			bool isInside = false;
+			double px = point.x, py = point.y;
+
+			for (size_t i = 0, j = loop.size() - 1; i < loop.size(); j = i++)
+			{
+				double ax = vertices[loop[i]].pos.x, ay = vertices[loop[i]].pos.y;
+				double bx = vertices[loop[j]].pos.x, by = vertices[loop[j]].pos.y;
+
+				if ((ay > py) != (by > py) && px < (bx - ax) * (py - ay) / (by - ay) + ax)
+					isInside = !isInside;
+			}
+
+			return isInside;
+		}
+
+		void pruneDangling(std::vector<Vertex> &vertices, std::vector<Edge> &edges)
+		{
+			// edges on each vertex, a loop from a vertex to itself only counts once
+			std::vector<unsigned> degrees(vertices.size(), 0), edgeStart(vertices.size() + 1, 0);
+			for (const Edge &edge : edges)
+				if (edge.type != EdgeType::REMOVED)
+				{
+					++edgeStart[edge.p1 + 1];
+					if (edge.p2 != edge.p1)
+						++edgeStart[edge.p2 + 1];
+				}
+			std::partial_sum(edgeStart.begin(), edgeStart.end(), edgeStart.begin());
+
+			std::vector<unsigned> incident(edgeStart.back()), fill(edgeStart.begin(), edgeStart.end() - 1);
+			for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
+				if (edges[i].type != EdgeType::REMOVED)
+				{
+					incident[fill[edges[i].p1]++] = i;
+					if (edges[i].p2 != edges[i].p1)
+						incident[fill[edges[i].p2]++] = i;
+				}
+
+			std::vector<unsigned> toRemove;
+			for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
+			{
+				degrees[i] = edgeStart[i + 1] - edgeStart[i];
+				if (vertices[i].type != VertexType::REMOVED && degrees[i] < 2)
+					toRemove.push_back(i);
+			}
+
+			// removing a vertex removes its edges, which can leave its neighbours dangling in turn
+			while (!toRemove.empty())
+			{
+				unsigned i = toRemove.back();
+				toRemove.pop_back();
+				if (vertices[i].type == VertexType::REMOVED)
+					continue;
+
+				vertices[i].type = VertexType::REMOVED;
+				for (unsigned j = edgeStart[i]; j < edgeStart[i + 1]; ++j)
+				{
+					Edge &edge = edges[incident[j]];
+					if (edge.type == EdgeType::REMOVED)
+						continue;
+
+					edge.type = EdgeType::REMOVED;
+					unsigned other = edge.p1 == i ? edge.p2 : edge.p1;
+					if (other != i && --degrees[other] < 2 && vertices[other].type != VertexType::REMOVED)
+						toRemove.push_back(other);
+				}
+			}
+		}
+
+		unsigned splitCrossings(std::vector<Vertex> &vertices, std::vector<Edge> &edges)
+		{
+			std::vector<SweepLine::Crossing> crossings = SweepLine().findCrossings(vertices, edges);
+			if (crossings.empty())
+				return 0;
+
+			// crossings closer than this relative to the shape's size are merged, so 3 edges through a point meet at
+			// 1 vertex despite rounding
+			float minX = std::numeric_limits<float>::max(), maxX = -minX, minY = minX, maxY = -minX;
+			for (const Vertex &vertex : vertices)
+			{
+				minX = std::min(minX, vertex.pos.x);
+				maxX = std::max(maxX, vertex.pos.x);
+				minY = std::min(minY, vertex.pos.y);
+				maxY = std::max(maxY, vertex.pos.y);
+			}
+
+			VertexHash hash(std::max(maxX - minX, maxY - minY) * MERGE_TOLERANCE);
+			for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
+				if (vertices[i].type != VertexType::REMOVED)
+					hash.add(vertices, i);
+
+			// points along each crossed edge, as how far along it they are
+			std::map<unsigned, std::vector<std::pair<double, unsigned>>> splits;
+			for (const SweepLine::Crossing &crossing : crossings)
+			{
+				unsigned vertex = hash.findOrAdd(vertices, Vec2(static_cast<float>(crossing.x),
+					static_cast<float>(crossing.y)));
+
+				for (unsigned e : { crossing.edge1, crossing.edge2 })
+				{
+					if (e == NONE)
+						continue;
+
+					Vec2 p1 = vertices[edges[e].p1].pos, p2 = vertices[edges[e].p2].pos;
+					double dx = static_cast<double>(p2.x) - p1.x, dy = static_cast<double>(p2.y) - p1.y;
+					splits[e].push_back({ ((crossing.x - p1.x) * dx + (crossing.y - p1.y) * dy) / (dx * dx + dy * dy),
+						vertex });
+				}
+			}
+
+			// replace each crossed edge with a chain of added edges through its crossings
+			for (auto &[e, points] : splits)
+			{
+				std::sort(points.begin(), points.end());
+				Edge edge = edges[e];
+				edges[e].type = EdgeType::REMOVED;
+
+				unsigned prev = edge.p1;
+				for (const std::pair<double, unsigned> &point : points)
+					if (point.second != prev && point.second != edge.p2)
+					{
+						edges.emplace_back(prev, point.second, EdgeType::ADDED, edge.isOutside);
+						prev = point.second;
+					}
+				edges.emplace_back(prev, edge.p2, EdgeType::ADDED, edge.isOutside);
+			}
+
+			return static_cast<unsigned>(crossings.size());
+		}
+
+		bool ifIsMoveSafe(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges, unsigned vertex,
+			Vec2 from)
+		{
+			Vec2 to = vertices[vertex].pos;
+			if (from == to || vertices[vertex].type == VertexType::REMOVED)
+				return true;
+
+			std::vector<unsigned> neighbours;
+			for (const Edge &edge : edges)
+				if (ifIsLive(vertices, edge) && (edge.p1 == vertex || edge.p2 == vertex))
+					neighbours.push_back(edge.p1 == vertex ? edge.p2 : edge.p1);
+
+			for (unsigned neighbour : neighbours)
+			{
+				// each edge on the vertex sweeps the triangle between where it was and where it is
+				Vec2 pivot = vertices[neighbour].pos;
+				double sweep = orient(pivot, from, to);
+				if (sweep == 0.0)
+					return false;
+
+				for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
+				{
+					if (i == vertex || i == neighbour || vertices[i].type == VertexType::REMOVED)
+						continue;
+
+					Vec2 pos = vertices[i].pos;
+					if (orient(pivot, from, pos) * sweep >= 0.0 && orient(from, to, pos) * sweep >= 0.0 &&
+						orient(to, pivot, pos) * sweep >= 0.0)
+						return false;
+				}
+
+				for (unsigned other : neighbours)
+					if (other != neighbour && ifDoesOverlap(to, pivot, vertices[other].pos))
+						return false;
+
+				for (const Edge &edge : edges)
+				{
+					if (!ifIsLive(vertices, edge) || edge.p1 == vertex || edge.p2 == vertex)
+						continue;
+
+					// an edge on the pivot mustn't be swept past or lie along the new edge
+					if (edge.p1 == neighbour || edge.p2 == neighbour)
+					{
+						Vec2 pos = vertices[edge.p1 == neighbour ? edge.p2 : edge.p1].pos;
+						if ((orient(pivot, from, pos) * sweep > 0.0 && orient(pivot, pos, to) * sweep > 0.0) ||
+							ifDoesOverlap(pivot, to, pos))
+							return false;
+					}
+					else if (ifDoSegmentsTouch(pivot, to, vertices[edge.p1].pos, vertices[edge.p2].pos))
+						return false;
+				}
+			}
+
+			return true;
+		}
+
+		bool ifIsEdgeClear(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges, unsigned edge)
+		{
+			const Edge &added = edges[edge];
+			Vec2 p1 = vertices[added.p1].pos, p2 = vertices[added.p2].pos;
+			if (p1 == p2)
+				return false;
+
+			for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
+			{
+				const Edge &other = edges[i];
+				if (i == edge || !ifIsLive(vertices, other))
+					continue;
+
+				if (other == added)
+					return false;
+
+				if (other.p1 == added.p1 || other.p2 == added.p1)
+				{
+					if (ifDoesOverlap(p1, p2, vertices[other.p1 == added.p1 ? other.p2 : other.p1].pos))
+						return false;
+				}
+				else if (other.p1 == added.p2 || other.p2 == added.p2)
+				{
+					if (ifDoesOverlap(p2, p1, vertices[other.p1 == added.p2 ? other.p2 : other.p1].pos))
+						return false;
+				}
+				else if (ifDoSegmentsTouch(p1, p2, vertices[other.p1].pos, vertices[other.p2].pos))
+					return false;
+			}
+
+			return true;
+		}
+
+		std::vector<Face> findFilledFaces(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges)
+		{
+			std::vector<GraphEdge> graph = collectEdges(vertices, edges);
+			if (graph.empty())
+				return {};
+
+			/*! ------------ Build half edges ------------ */
+
+			// half edge h runs from p1 to p2 when even and back when odd, so its twin is h ^ 1
+			unsigned halfCount = static_cast<unsigned>(graph.size() * 2);
+			auto getOrigin = [&graph](unsigned h) { return h & 1 ? graph[h >> 1].p2 : graph[h >> 1].p1; };
+			auto getPos = [&vertices](unsigned v) { return vertices[v].pos; };
+
+			// outgoing half edges of each vertex, sorted counter clockwise by angle
+			std::vector<unsigned> outStart(vertices.size() + 1, 0), outgoing(halfCount), outIndex(halfCount);
+			for (unsigned h = 0; h < halfCount; ++h)
+				++outStart[getOrigin(h) + 1];
+			std::partial_sum(outStart.begin(), outStart.end(), outStart.begin());
+
+			std::vector<unsigned> fill(outStart.begin(), outStart.end() - 1);
+			for (unsigned h = 0; h < halfCount; ++h)
+				outgoing[fill[getOrigin(h)]++] = h;
+
+			std::vector<double> angles(halfCount);
+			for (unsigned h = 0; h < halfCount; ++h)
+			{
+				Vec2 from = getPos(getOrigin(h)), to = getPos(getOrigin(h ^ 1));
+				angles[h] = std::atan2(static_cast<double>(to.y) - from.y, static_cast<double>(to.x) - from.x);
+			}
+
+			for (size_t v = 0; v < vertices.size(); ++v)
+			{
+				std::sort(outgoing.begin() + outStart[v], outgoing.begin() + outStart[v + 1],
+					[&angles](unsigned a, unsigned b) { return angles[a] < angles[b]; });
+				for (unsigned i = outStart[v]; i < outStart[v + 1]; ++i)
+					outIndex[outgoing[i]] = i - outStart[v];
+			}
+
+			// the next half edge round a face is the one just clockwise of the twin at the far end
+			auto getNext = [&](unsigned h) {
+				unsigned v = getOrigin(h ^ 1), degree = outStart[v + 1] - outStart[v];
+				return outgoing[outStart[v] + (outIndex[h ^ 1] + degree - 1) % degree];
+			};
+
+			/*! ------------ Walk cycles ------------ */
+
+			std::vector<unsigned> cycleOf(halfCount, NONE);
+			std::vector<std::vector<unsigned>> cycles; // as half edges
+			std::vector<double> areas;
+
+			for (unsigned h = 0; h < halfCount; ++h)
+				if (cycleOf[h] == NONE)
+				{
+					unsigned cycle = static_cast<unsigned>(cycles.size());
+					cycles.emplace_back();
+					double area = 0.0;
+
+					for (unsigned curr = h; cycleOf[curr] == NONE; curr = getNext(curr))
+					{
+						cycleOf[curr] = cycle;
+						cycles.back().push_back(curr);
+
+						Vec2 a = getPos(getOrigin(curr)), b = getPos(getOrigin(curr ^ 1));
+						area += static_cast<double>(a.x) * b.y - static_cast<double>(b.x) * a.y;
+					}
+
+					areas.push_back(area / 2.0);
+				}
+
+			auto getLoop = [&](unsigned cycle) {
+				std::vector<unsigned> loop;
+				loop.reserve(cycles[cycle].size());
+				for (unsigned h : cycles[cycle])
+					loop.push_back(getOrigin(h));
+				return loop;
+			};
+
+			/*! ------------ Assign cycles to regions ------------ */
+
+			// every connected piece of the graph has one clockwise cycle round its outside, which is a hole in the
+			// smallest counter clockwise cycle of another piece around it, or in the unbounded region if there's none
+			std::vector<unsigned> parents(vertices.size());
+			std::iota(parents.begin(), parents.end(), 0u);
+			for (const GraphEdge &edge : graph)
+				parents[findRoot(parents, edge.p1)] = findRoot(parents, edge.p2);
+
+			std::vector<unsigned> regionOf(cycles.size(), NONE), outerCycles;
+			std::vector<std::vector<unsigned>> outerLoops;
+			for (unsigned c = 0; c < cycles.size(); ++c)
+				if (areas[c] > 0.0)
+				{
+					regionOf[c] = static_cast<unsigned>(outerCycles.size());
+					outerCycles.push_back(c);
+					outerLoops.push_back(getLoop(c));
+				}
+
+			unsigned unbounded = static_cast<unsigned>(outerCycles.size());
+			std::vector<std::vector<unsigned>> regionHoles(outerCycles.size() + 1);
+
+			for (unsigned c = 0; c < cycles.size(); ++c)
+				if (regionOf[c] == NONE)
+				{
+					unsigned vertex = getOrigin(cycles[c].front()), piece = findRoot(parents, vertex);
+					regionOf[c] = unbounded;
+
+					for (unsigned r = 0; r < outerCycles.size(); ++r)
+						if (findRoot(parents, getOrigin(cycles[outerCycles[r]].front())) != piece &&
+							(regionOf[c] == unbounded || areas[outerCycles[r]] < areas[outerCycles[regionOf[c]]]) &&
+							ifIsInPolygon(getPos(vertex), vertices, outerLoops[r]))
+							regionOf[c] = r;
+
+					regionHoles[regionOf[c]].push_back(c);
+				}
+
+			/*! ------------ Even odd fill ------------ */
+
+			// the unbounded region is empty, and crossing an outside edge into a neighbouring region flips it
+			std::vector<int> parities(outerCycles.size() + 1, -1);
+			std::queue<unsigned> toVisit;
+			parities[unbounded] = 0;
+			toVisit.push(unbounded);
+
+			auto visitCycle = [&](unsigned c, int parity) {
+				for (unsigned h : cycles[c])
+				{
+					unsigned neighbour = regionOf[cycleOf[h ^ 1]];
+					if (parities[neighbour] == -1)
+					{
+						parities[neighbour] = parity ^ static_cast<int>(graph[h >> 1].isOutside);
+						toVisit.push(neighbour);
+					}
+				}
+			};
+
+			while (!toVisit.empty())
+			{
+				unsigned region = toVisit.front();
+				toVisit.pop();
+
+				if (region != unbounded)
+					visitCycle(outerCycles[region], parities[region]);
+				for (unsigned c : regionHoles[region])
+					visitCycle(c, parities[region]);
+			}
+
+			std::vector<Face> faces;
+			for (unsigned r = 0; r < outerCycles.size(); ++r)
+				if (parities[r] == 1)
+				{
+					Face face;
+					face.outer = std::move(outerLoops[r]);
+					for (unsigned c : regionHoles[r])
+						face.holes.push_back(getLoop(c));
+					faces.push_back(std::move(face));
+				}
+
+			return faces;
+		}
+
+		void earClip(const std::vector<Vertex> &vertices, const Face &face, std::vector<Triangle> &triangles)
+		{
+			EarClipper().clip(vertices, face, triangles);
+		}
+
+		void triangulateDelaunay(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges,
+			std::vector<Triangle> &triangles)
+		{
+			// rounding can in theory stop a constraint being recovered, ear clipping always respects the edges
+			if (!DelaunayTriangulator().triangulate(vertices, edges, triangles))
+				for (const Face &face : findFilledFaces(vertices, edges))
+					earClip(vertices, face, triangles);
+		}
+
+		std::vector<Triangle> triangulate(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges,
+			TriangulationMode mode)
+		{
+			std::vector<Triangle> triangles;
+			if (mode == TriangulationMode::CONSTRAINED_DELAUNAY)
+				triangulateDelaunay(vertices, edges, triangles);
+			else
+				for (const Face &face : findFilledFaces(vertices, edges))
+					earClip(vertices, face, triangles);
+
+			std::sort(triangles.begin(), triangles.end());
+			return triangles;
+		}
+
+	}
+
+}
\ No newline at end of file
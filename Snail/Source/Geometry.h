@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Types.h"
+
+#include <vector>
+
+namespace Snail
+{
+
+	namespace Geometry
+	{
+
+		// a filled region of a shape's edge graph as loops of vertex indices
+		// the outer loop runs counter clockwise and the holes clockwise, so the face is always on the left
+		struct Face
+		{
+			std::vector<unsigned> outer;
+			std::vector<std::vector<unsigned>> holes;
+		};
+
+		// twice the signed area of abc, positive when abc turns counter clockwise
+		double orient(Vec2 a, Vec2 b, Vec2 c);
+		bool ifIsInPolygon(Vec2 point, const std::vector<Vertex> &vertices, const std::vector<unsigned> &loop);
+
+		// repeatedly removes vertices on fewer than 2 edges along with their edges, in O(V + E) from a worklist of
+		// vertices whose count of edges that aren't removed has dropped below 2
+		void pruneDangling(std::vector<Vertex> &vertices, std::vector<Edge> &edges);
+
+		// splits every pair of edges whose interiors cross at a shared vertex, reusing any vertex already there, and
+		// every edge another's endpoint lies on. crossings are found by a bentley ottmann sweep in O((n + k) log n)
+		// and the split edges are marked removed and replaced by chains of added edges. returns the number of splits
+		unsigned splitCrossings(std::vector<Vertex> &vertices, std::vector<Edge> &edges);
+
+		// whether moving a vertex from where it was to where it is keeps every face the same apart from the ones on
+		// it, ie no edge on it swept over a vertex or another edge and none of them now touch anything
+		bool ifIsMoveSafe(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges, unsigned vertex,
+			Vec2 from);
+
+		// whether an edge touches no other edge except where they share an endpoint
+		bool ifIsEdgeClear(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges, unsigned edge);
+
+		// walks the faces of the planar graph made by the edges that aren't removed, and keeps those that are filled
+		// by the even odd rule, where crossing an outside edge flips between filled and empty and inside edges don't
+		// edges must not cross each other except at shared vertices, and vertices in the same place count as one
+		std::vector<Face> findFilledFaces(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges);
+
+		// bridges the face's holes into its outer loop then clips ears, only reflex vertices can lie inside a
+		// candidate ear so they're kept in a grid and only the ones under the ear are tested
+		void earClip(const std::vector<Vertex> &vertices, const Face &face, std::vector<Triangle> &triangles);
+
+		// delaunay triangulates every vertex on an edge, forces the edges in, then keeps the triangles the even odd
+		// rule fills. fills the same area as findFilledFaces plus earClip with different triangles, without slivers
+		// but at a few times the cost. edges left dangling, eg where 2 outside edges on top of each other cancel out,
+		// aren't part of any face there but still split the fill here, so the 2 only agree once those are gone
+		void triangulateDelaunay(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges,
+			std::vector<Triangle> &triangles);
+
+		// triangles of every filled face, each with its indices in ascending order and sorted
+		std::vector<Triangle> triangulate(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges,
+			TriangulationMode mode = TriangulationMode::EAR_CLIPPING);
+
+	}
+
+}
\ No newline at end of file
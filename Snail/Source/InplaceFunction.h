@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Utility.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Snail
+{
+
+	template <typename Signature, size_t CAPACITY = 48>
+	class InplaceFunction;
+
+	// a move only std::function that keeps its callable in a fixed buffer, so creating, moving and calling one
+	// never allocates. callables that do not fit are a compile error rather than a silent heap fallback
+	template <typename Ret, typename... Args, size_t CAPACITY>
+	class InplaceFunction<Ret(Args...), CAPACITY>
+	{
+		// one table per callable type, shared by every InplaceFunction holding that type
+		struct Ops
+		{
+			Ret (*invoke)(void *, Args &&...);
+			void (*move)(void *, void *); // move constructs into the first from the second, then destroys the second
+			void (*destroy)(void *);
+		};
+
+		template <typename Func>
+		static constexpr Ops opsFor = {
+			[](void *func, Args &&...args) -> Ret {
+				return (*static_cast<Func *>(func))(std::forward<Args>(args)...); },
+			[](void *dst, void *src) {
+				new (dst) Func(std::move(*static_cast<Func *>(src)));
+				static_cast<Func *>(src)->~Func(); },
+			[](void *func) { static_cast<Func *>(func)->~Func(); }
+		};
+
+		alignas(std::max_align_t) unsigned char buffer[CAPACITY];
+		const Ops *ops = nullptr;
+
+	public:
+
+		InplaceFunction() = default;
+
+		InplaceFunction(std::nullptr_t)
+		{
+
+		}
+
+		template <typename Func, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, InplaceFunction>>>
+		InplaceFunction(Func &&func)
+		{
+			using Stored = std::decay_t<Func>;
+			static_assert(sizeof(Stored) <= CAPACITY, "Callable is too big for this InplaceFunction");
+			static_assert(alignof(Stored) <= alignof(std::max_align_t), "Callable is over aligned");
+			static_assert(std::is_invocable_r_v<Ret, Stored &, Args...>, "Callable has the wrong signature");
+
+			new (buffer) Stored(std::forward<Func>(func));
+			ops = &opsFor<Stored>;
+		}
+
+		InplaceFunction(InplaceFunction &&that) noexcept
+		{
+			if (that.ops)
+			{
+				that.ops->move(buffer, that.buffer);
+				ops = std::exchange(that.ops, nullptr);
+			}
+		}
+
+		InplaceFunction &operator=(InplaceFunction &&that) noexcept
+		{
+			if (this != &that)
+			{
+				reset();
+				if (that.ops)
+				{
+					that.ops->move(buffer, that.buffer);
+					ops = std::exchange(that.ops, nullptr);
+				}
+			}
+			return *this;
+		}
+
+		InplaceFunction &operator=(std::nullptr_t)
+		{
+			reset();
+			return *this;
+		}
+
+		InplaceFunction(const InplaceFunction &) = delete;
+		InplaceFunction &operator=(const InplaceFunction &) = delete;
+
+		~InplaceFunction()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			if (ops)
+				std::exchange(ops, nullptr)->destroy(buffer);
+		}
+
+		explicit operator bool() const
+		{
+			return ops;
+		}
+
+		Ret operator()(Args... args)
+		{
+			crashIf(!ops, "Called an empty InplaceFunction");
+			return ops->invoke(buffer, std::forward<Args>(args)...);
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "JobSystem.h"
+
+namespace Snail
+{
+
+	namespace
+	{
+		// index of the calling thread's deque, threads that are not workers use the last one
+		thread_local unsigned currQueue = static_cast<unsigned>(-1);
+	}
+
+	bool JobHandle::isDone() const
+	{
+		return !group || !group->remaining;
+	}
+
+	void JobSystem::init()
+	{
+		// leave one core for the main thread
+		unsigned workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+		isRunning = true;
+		isExclusive = false; // update does nothing
+
+		for (unsigned i = 0; i <= workerCount; ++i)
+			queues.push_back(std::make_unique<JobQueue>());
+		for (unsigned i = 0; i < workerCount; ++i)
+			workers.emplace_back(&JobSystem::runWorker, this, i);
+	}
+
+	void JobSystem::update()
+	{
+
+	}
+
+	void JobSystem::free()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			isRunning = false;
+		}
+
+		hasJobs.notify_all();
+		for (std::thread &worker : workers)
+			worker.join();
+		workers.clear();
+		queues.clear();
+	}
+
+	void JobSystem::runWorker(unsigned index)
+	{
+		currQueue = index;
+
+		while (isRunning)
+		{
+			Job job;
+			if (findJob(job))
+			{
+				execute(job);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			hasJobs.wait(lock, [this]() { return !isRunning || pendingJobs; });
+		}
+	}
+
+	void JobSystem::push(Job job)
+	{
+		JobQueue &queue = *queues[std::min(currQueue, static_cast<unsigned>(queues.size() - 1))];
+
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(std::move(job));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			++pendingJobs;
+		}
+
+		hasJobs.notify_one();
+	}
+
+	bool JobSystem::findJob(Job &job)
+	{
+		unsigned queueCount = static_cast<unsigned>(queues.size());
+		unsigned own = std::min(currQueue, queueCount - 1);
+
+		for (unsigned i = 0; i < queueCount; ++i)
+		{
+			JobQueue &queue = *queues[(own + i) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.jobs.empty())
+				continue;
+
+			// newest from our own deque since it is most likely still in cache, oldest from anyone else's
+			if (!i)
+			{
+				job = std::move(queue.jobs.back());
+				queue.jobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue.jobs.front());
+				queue.jobs.pop_front();
+			}
+
+			--pendingJobs;
+			return true;
+		}
+
+		return false;
+	}
+
+	void JobSystem::execute(Job &job)
+	{
+		job.func();
+
+		if (--job.group->remaining)
+			return;
+
+		std::vector<std::function<void()>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(job.group->mutex);
+			continuations.swap(job.group->continuations);
+		}
+
+		for (std::function<void()> &continuation : continuations)
+			continuation();
+	}
+
+	JobHandle JobSystem::submit(std::function<void()> job, JobHandle handle)
+	{
+		if (!handle.group)
+			handle.group = std::make_shared<JobGroup>();
+
+		++handle.group->remaining;
+		push({ std::move(job), handle.group });
+		return handle;
+	}
+
+	JobHandle JobSystem::then(const JobHandle &handle, std::function<void()> continuation)
+	{
+		JobHandle next;
+		next.group = std::make_shared<JobGroup>();
+		next.group->remaining = 1; // counted now so next is not done before continuation has even started
+
+		auto pushContinuation = [this, group = next.group, continuation = std::move(continuation)]() {
+			push({ continuation, group }); };
+
+		if (handle.group)
+		{
+			std::lock_guard<std::mutex> lock(handle.group->mutex);
+			if (handle.group->remaining)
+			{
+				handle.group->continuations.push_back(std::move(pushContinuation));
+				return next;
+			}
+		}
+
+		pushContinuation();
+		return next;
+	}
+
+	void JobSystem::wait(const JobHandle &handle)
+	{
+		while (!handle.isDone())
+		{
+			Job job;
+			if (findJob(job))
+				execute(job);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	unsigned JobSystem::getWorkerCount()
+	{
+		return static_cast<unsigned>(workers.size());
+	}
+
+}
\ No newline at end of file
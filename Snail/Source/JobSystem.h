@@ -0,0 +1,78 @@
+#pragma once
+
+#include "System.h"
+#include "Utility.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+
+namespace Snail
+{
+
+	// a group of jobs that is finished once every job submitted into it has run
+	struct JobGroup
+	{
+		std::atomic<unsigned> remaining = 0;
+		std::mutex mutex; // guards continuations
+		std::vector<std::function<void()>> continuations; // submitted once remaining reaches 0
+	};
+
+	class JobHandle
+	{
+		friend class JobSystem;
+		std::shared_ptr<JobGroup> group;
+
+	public:
+
+		bool isDone() const;
+	};
+
+	struct Job
+	{
+		std::function<void()> func;
+		std::shared_ptr<JobGroup> group;
+	};
+
+	// work stealing thread pool, each worker pushes and pops jobs at the back of its own deque and steals
+	// from the front of the others' when it runs out, threads that are not workers share one extra deque
+	class JobSystem : public System
+	{
+		struct JobQueue
+		{
+			std::mutex mutex;
+			std::deque<Job> jobs;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<JobQueue>> queues; // one per worker plus one for everyone else
+		std::atomic<unsigned> pendingJobs = 0;
+		std::atomic<bool> isRunning = false;
+		std::mutex sleepMutex;
+		std::condition_variable hasJobs;
+
+		void runWorker(unsigned index);
+		void push(Job job);
+		bool findJob(Job &job); // pops from the caller's own deque first, then steals
+		void execute(Job &job);
+
+	public:
+
+		void init() override;
+		void update() override;
+		void free() override;
+
+		// adds the job to handle's group if one is given, otherwise starts a new group
+		JobHandle submit(std::function<void()> job, JobHandle handle = JobHandle());
+		// runs continuation once everything in handle has finished, the returned handle tracks continuation
+		JobHandle then(const JobHandle &handle, std::function<void()> continuation);
+		// runs other jobs on the calling thread until everything in handle has finished
+		void wait(const JobHandle &handle);
+
+		unsigned getWorkerCount();
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace Snail
+{
+
+	// array indexed by entity index whose memory is allocated one page at a time as indices are used,
+	// so sparse lookups stay O(1) without reserving space for every possible entity up front
+	template <typename T, size_t PAGE_SIZE = 1024>
+	class PagedArray
+	{
+		std::vector<std::unique_ptr<std::array<T, PAGE_SIZE>>> pages;
+
+	public:
+
+		// allocates the page that holds index if it does not exist yet (new elements are value initialised)
+		T &operator[](size_t index)
+		{
+			size_t page = index / PAGE_SIZE;
+			if (page >= pages.size())
+				pages.resize(page + 1);
+			if (!pages[page])
+				pages[page] = std::make_unique<std::array<T, PAGE_SIZE>>();
+			return (*pages[page])[index % PAGE_SIZE];
+		}
+
+		// returns nullptr instead of allocating if the page that holds index does not exist
+		const T *find(size_t index) const
+		{
+			size_t page = index / PAGE_SIZE;
+			if (page >= pages.size() || !pages[page])
+				return nullptr;
+			return &(*pages[page])[index % PAGE_SIZE];
+		}
+	};
+
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "Profiler.h"
+#include "Core.h"
+
+namespace Snail
+{
+
+	namespace
+	{
+		thread_local ProfileRing *currRing = nullptr;
+		thread_local unsigned currDepth = 0;
+	}
+
+	ProfileData::ProfileData(float _actual, float _percent)
+		: actual(_actual), percent(_percent)
+	{
+
+	}
+
+	std::string ProfileData::stringify() const
+	{
+		return "{ actual: " + toStr(actual) + "; percent: " + toStr(percent) + "}";
+	}
+
+	ProfileZone::ProfileZone(LabelId _label)
+		: label(_label), begin(gs(Profiler)->now())
+	{
+		++currDepth;
+	}
+
+	ProfileZone::~ProfileZone()
+	{
+		ProfileRecord record;
+		record.label = label;
+		record.depth = --currDepth;
+		record.begin = begin;
+		record.end = gs(Profiler)->now();
+		gs(Profiler)->record(record);
+	}
+
+	void Profiler::init()
+	{
+		isExclusive = false; // update does nothing
+	}
+
+	void Profiler::update()
+	{
+
+	}
+
+	void Profiler::free()
+	{
+		endCapture();
+		std::lock_guard<std::mutex> lock(mutex);
+		rings.clear();
+		currRing = nullptr;
+	}
+
+	LabelId Profiler::internLabel(const std::string &label)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto [iter, isNew] = labelIds.try_emplace(label, static_cast<LabelId>(labelNames.size()));
+		if (isNew)
+			labelNames.push_back(label);
+		return iter->second;
+	}
+
+	const std::string &Profiler::getLabelName(LabelId label)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		crashIf(label >= labelNames.size(), "Invalid profile label " + toStr(label));
+		return labelNames[label];
+	}
+
+	long long Profiler::now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(rightNow - start).count();
+	}
+
+	void Profiler::record(const ProfileRecord &record)
+	{
+		if (!currRing)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			rings.push_back(std::make_unique<ProfileRing>());
+			rings.back()->thread = static_cast<unsigned>(rings.size() - 1);
+			currRing = rings.back().get();
+		}
+
+		size_t head = currRing->head.load(std::memory_order_relaxed);
+		if (head - currRing->tail.load(std::memory_order_acquire) >= PROFILE_RING_SIZE)
+			return;
+
+		ProfileRecord &slot = currRing->records[head % PROFILE_RING_SIZE];
+		slot = record;
+		slot.thread = currRing->thread;
+		currRing->head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::endFrame(float frameTime)
+	{
+		frameRecords.clear();
+		size_t labelCount;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			labelCount = labelNames.size();
+
+			for (auto &ring : rings)
+			{
+				size_t tail = ring->tail.load(std::memory_order_relaxed);
+				size_t head = ring->head.load(std::memory_order_acquire);
+				for (; tail != head; ++tail)
+					frameRecords.push_back(ring->records[tail % PROFILE_RING_SIZE]);
+				ring->tail.store(tail, std::memory_order_release);
+			}
+		}
+
+		// reuse the oldest frame's vector instead of copying the current one
+		std::vector<ProfileData> &totals = history[frameCount++ % PROFILE_HISTORY];
+		totals.assign(labelCount, ProfileData());
+
+		for (const ProfileRecord &record : frameRecords)
+			totals[record.label].actual += static_cast<float>(record.end - record.begin) / 1e9f;
+
+		if (frameTime > 0.f)
+			for (ProfileData &data : totals)
+				data.percent = data.actual / frameTime;
+
+		if (isCapturing())
+		{
+			writeCapture();
+			if (!--captureFramesLeft)
+				endCapture();
+		}
+	}
+
+	void Profiler::beginCapture(unsigned _frameCount, const std::string &path)
+	{
+		crashIf(!_frameCount, "Must capture at least 1 frame");
+		endCapture();
+
+		capture.open(path);
+		crashIf(!capture, "Unable to open " + Util::quote(path) + " for writing");
+		capture << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		captureFramesLeft = _frameCount;
+		isFirstCaptureEvent = true;
+	}
+
+	void Profiler::endCapture()
+	{
+		if (!capture.is_open())
+			return;
+
+		capture << "\n]}\n";
+		capture.close();
+		captureFramesLeft = 0;
+	}
+
+	bool Profiler::isCapturing()
+	{
+		return capture.is_open();
+	}
+
+	void Profiler::writeCapture()
+	{
+		// complete events ("X") take microseconds, the frame boundary is an instant event ("i") across all threads
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(3);
+
+		for (const ProfileRecord &record : frameRecords)
+		{
+			oss << (isFirstCaptureEvent ? "\n" : ",\n") << "{\"name\":" << Util::quote(getLabelName(record.label))
+				<< ",\"ph\":\"X\",\"pid\":0,\"tid\":" << record.thread << ",\"ts\":" << record.begin / 1e3
+				<< ",\"dur\":" << (record.end - record.begin) / 1e3 << "}";
+			isFirstCaptureEvent = false;
+		}
+
+		oss << (isFirstCaptureEvent ? "\n" : ",\n") << "{\"name\":\"Frame " << frameCount 
+			<< "\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":" << now() / 1e3 << "}";
+		isFirstCaptureEvent = false;
+
+		capture << oss.str();
+	}
+
+	const std::vector<ProfileRecord> &Profiler::getFrameRecords()
+	{
+		return frameRecords;
+	}
+
+	const std::vector<ProfileData> &Profiler::getProfileData(size_t framesAgo)
+	{
+		crashIf(framesAgo >= PROFILE_HISTORY || framesAgo >= frameCount, "Profile data from " + 
+			toStr(framesAgo) + " frames ago is not available");
+		return history[(frameCount - 1 - framesAgo) % PROFILE_HISTORY];
+	}
+
+}
\ No newline at end of file
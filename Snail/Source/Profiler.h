@@ -0,0 +1,113 @@
+#pragma once
+
+#include "System.h"
+#include "Utility.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <fstream>
+
+/*! ------------ Macros ------------ */
+
+#define profileConcat(a, b) a##b
+#define profileName(a, b) profileConcat(a, b)
+// times the rest of the enclosing scope, label is interned once per call site
+#define profileScope(label) \
+	static const LabelId profileName(profileLabel, __LINE__) = gs(Profiler)->internLabel(label); \
+	ProfileZone profileName(profileZone, __LINE__)(profileName(profileLabel, __LINE__))
+
+namespace Snail
+{
+
+	constexpr unsigned PROFILE_RING_SIZE = 4096; // zones each thread can record per frame before dropping
+	constexpr unsigned PROFILE_HISTORY = 128; // frames of totals kept
+
+	struct ProfileData : public Debugger::Printable
+	{
+		float actual;
+		float percent;
+
+		ProfileData(float _actual = 0.f, float _percent = 0.f);
+
+		std::string stringify() const override;
+	};
+
+	struct ProfileRecord
+	{
+		LabelId label = 0;
+		unsigned depth = 0; // how many zones this one is nested in
+		unsigned thread = 0; // index of the recording thread in the order threads first profiled something
+		long long begin = 0, end = 0; // nanoseconds since the profiler started
+	};
+
+	// single producer single consumer ring, only the owning thread pushes and only endFrame pops
+	struct ProfileRing
+	{
+		std::array<ProfileRecord, PROFILE_RING_SIZE> records;
+		std::atomic<size_t> head = 0; // next slot to write
+		std::atomic<size_t> tail = 0; // next slot to read
+		unsigned thread = 0;
+	};
+
+	// RAII zone, nests with any zones already open on the same thread
+	class ProfileZone
+	{
+		LabelId label;
+		long long begin;
+
+	public:
+
+		explicit ProfileZone(LabelId _label);
+		~ProfileZone();
+
+		ProfileZone(const ProfileZone &) = delete;
+		ProfileZone &operator=(const ProfileZone &) = delete;
+	};
+
+	class Profiler : public System
+	{
+		std::chrono::steady_clock::time_point start = rightNow;
+
+		std::mutex mutex; // only for interning labels and registering new threads
+		std::unordered_map<std::string, LabelId> labelIds;
+		std::vector<std::string> labelNames;
+		std::vector<std::unique_ptr<ProfileRing>> rings;
+
+		std::vector<ProfileRecord> frameRecords; // every zone in the last frame, in the order they ended
+		std::array<std::vector<ProfileData>, PROFILE_HISTORY> history; // per frame totals indexed by label
+		size_t frameCount = 0;
+
+		std::ofstream capture; // chrome trace event json, open while capturing
+		unsigned captureFramesLeft = 0;
+		bool isFirstCaptureEvent = true;
+
+		void writeCapture();
+
+	public:
+
+		void init() override;
+		void update() override;
+		void free() override;
+
+		LabelId internLabel(const std::string &label);
+		const std::string &getLabelName(LabelId label);
+
+		long long now(); // nanoseconds since the profiler started
+		void record(const ProfileRecord &record); // for ProfileZone, drops the record if the ring is full
+
+		void endFrame(float frameTime); // collects every thread's zones, call once all systems are done
+
+		// streams every zone of the next frameCount frames to a json file that chrome://tracing or 
+		// ui.perfetto.dev can open
+		void beginCapture(unsigned frameCount, const std::string &path = "Assets/Data/trace.json");
+		void endCapture();
+		bool isCapturing();
+
+		const std::vector<ProfileRecord> &getFrameRecords();
+		const std::vector<ProfileData> &getProfileData(size_t framesAgo = 0); // indexed by label
+	};
+
+}
\ No newline at end of file
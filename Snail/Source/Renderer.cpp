@@ -6,6 +6,7 @@
 #include "ComponentManager.h"
 #include "EntityManager.h"
 #include "Timer.h"
+#include "Profiler.h"
 
 #include <iostream> // for debugging
 
@@ -53,17 +54,22 @@ namespace Snail
 
 		// set static uniforms
 		glUniform2f(gs(Renderer)->getUniform("screenSize"), window.size.x, window.size.y);
+
+		// rebuilds shapes and reads their transforms, and has to stay on the thread with the OpenGL context
+		reads.set(gs(ComponentManager)->getCompId<TransformComponent>());
+		writes.set(gs(ComponentManager)->getCompId<ShapeComponent>());
+		isExclusive = false;
 	}
 
 	void Renderer::update()
 	{
-		for (EntityId entity : gs(EntityManager)->getEntityIds())
-		{
-			if (!gs(EntityManager)->hasAllComponents(entity, { "Shape", "Transform" }))
-				continue;
+		View<ShapeComponent, TransformComponent> view = 
+			gs(ComponentManager)->getView<ShapeComponent, TransformComponent>();
 
-			ShapeComponent &shape = gs(ComponentManager)->getComponent<ShapeComponent>(entity);
-			TransformComponent &transform = gs(ComponentManager)->getComponent<TransformComponent>(entity);
+		for (EntityId entity : view)
+		{
+			ShapeComponent &shape = view.get<ShapeComponent>(entity);
+			TransformComponent transform = view.get<TransformComponent>(entity).interpolate(gs(Time)->getAlpha());
 
 			//shape.translate(Vec2(50.f, 20.f) * gs(Time)->getDt().actual);
 			//shape.rotate(PI / 4.f * gs(Time)->getDt().actual);
@@ -72,6 +78,8 @@ namespace Snail
 			//transform.scale += Vec2(50.f, 20.f) * gs(Time)->getDt().actual;
 			shape.update();
 
+			profileScope("Shape draw");
+
 			if (shape.triangles.size())
 			{
 				glUniform4f(getUniform("fillColor"), shape.fillColor.r, shape.fillColor.g, shape.fillColor.b,
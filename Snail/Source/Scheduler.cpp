@@ -0,0 +1,73 @@
+#include "Scheduler.h"
+#include "Core.h"
+#include "JobSystem.h"
+#include "CommandBuffer.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace Snail
+{
+
+	bool Scheduler::ifIsConflicting(const System &system1, const System &system2)
+	{
+		return system1.isExclusive || system2.isExclusive || 
+			system1.writes.intersects(system2.reads | system2.writes) || system2.writes.intersects(system1.reads);
+	}
+
+	void Scheduler::buildWaves(const std::vector<System *> &systems)
+	{
+		// each system goes in the wave after the latest earlier system it conflicts with
+		std::vector<size_t> waveOf(systems.size(), 0);
+
+		for (size_t i = 0; i < systems.size(); ++i)
+			for (size_t j = 0; j < i; ++j)
+				if (ifIsConflicting(*systems[i], *systems[j]))
+					waveOf[i] = std::max(waveOf[i], waveOf[j] + 1);
+
+		for (std::vector<System *> &wave : waves)
+			wave.clear();
+
+		for (size_t i = 0; i < systems.size(); ++i)
+		{
+			if (waveOf[i] >= waves.size())
+				waves.resize(waveOf[i] + 1);
+			waves[waveOf[i]].push_back(systems[i]);
+		}
+	}
+
+	void Scheduler::update(System *system)
+	{
+		if (!system->shldProfile)
+		{
+			system->update();
+			return;
+		}
+
+		ProfileZone zone(system->profileLabel);
+		system->update();
+	}
+
+	void Scheduler::run(const std::vector<System *> &systems)
+	{
+		// rebuilt every frame since systems can change what they access at runtime
+		buildWaves(systems);
+
+		for (const std::vector<System *> &wave : waves)
+		{
+			JobHandle handle;
+
+			for (System *system : wave)
+				if (!system->shldRunOnMainThread)
+					handle = gs(JobSystem)->submit([system]() { update(system); }, handle);
+
+			for (System *system : wave)
+				if (system->shldRunOnMainThread)
+					update(system);
+
+			gs(JobSystem)->wait(handle); // main thread helps out with the rest
+			gs(CommandBuffer)->flush(); // sync point
+		}
+	}
+
+}
\ No newline at end of file
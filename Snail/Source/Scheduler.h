@@ -0,0 +1,28 @@
+#pragma once
+
+#include "System.h"
+
+#include <vector>
+
+namespace Snail
+{
+
+	// runs systems in waves, where no two systems in the same wave conflict over components
+	// systems in a wave are split between the main thread and the job system's workers, and
+	// structural changes from the command buffer are applied between waves
+	class Scheduler
+	{
+		std::vector<std::vector<System *>> waves;
+
+		void buildWaves(const std::vector<System *> &systems);
+		static void update(System *system); // wrapped in a profile zone if the system wants to be profiled
+
+	public:
+
+		static bool ifIsConflicting(const System &system1, const System &system2);
+
+		// systems that conflict always run in the given order
+		void run(const std::vector<System *> &systems);
+	};
+
+}
\ No newline at end of file
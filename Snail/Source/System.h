@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Types.h"
+
 #include <string>
 
 namespace Snail
@@ -10,7 +12,16 @@ namespace Snail
 	public:
 
 		std::string systemName;
-		bool shldProfile = true;
+		bool shldProfile = true; // whether update() is timed by the profiler
+		LabelId profileLabel = 0;
+
+		// what update() touches, used by the scheduler to decide which systems can run at the same time
+		// systems that have not declared their access stay exclusive and run alone on the main thread
+		Signature reads;
+		Signature writes;
+		bool isExclusive = true; // conflicts with every other system regardless of reads and writes
+		bool shldRunOnMainThread = true; // anything that touches OpenGL or ImGui must stay on the main thread
+		bool isFixedStep = false; // update() runs at Time's tick rate with getFixedDt() instead of once per frame
 
 		virtual void init() = 0;
 		virtual void update() = 0;
@@ -1,5 +1,18 @@
 #include "Timer.h"
 #include "Utility.h"
+#include "Profiler.h"
+#include "Core.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm")
+#endif
 
 namespace Snail
 {
@@ -20,54 +33,75 @@ namespace Snail
 		return "{ actual: " + toStr(actual) + "; target: " + toStr(target) + "}";
 	}
 
-	ProfileData::ProfileData(float _actual, float _percent)
-		: actual(_actual), percent(_percent)
-	{
-
-	}
-
-	std::string ProfileData::stringify() const
-	{
-		return "{ actual: " + toStr(actual) + "; target: " + toStr(percent) + "}";
-	}
-
 	void Time::init()
 	{
-
+		// stays exclusive on the main thread, callbacks can touch any component and declare nothing
 	}
 
 	void Time::update()
 	{
-		for (Timer &timer : timers)
-			if (timer.isActive)
+		std::unique_lock<std::mutex> lock(mutex);
+		elapsed += dt.actual;
+
+		dueEvents.clear();
+		while (!events.empty() && events.front().deadline <= elapsed)
+		{
+			std::pop_heap(events.begin(), events.end(), std::greater<TimerEvent>());
+			dueEvents.push_back(events.back());
+			events.pop_back();
+		}
+
+		// callbacks run unlocked since they may add or cancel timers, so the callback is moved out of its slot
+		// while it runs in case the timers vector grows underneath it
+		for (const TimerEvent &event : dueEvents)
+		{
+			Timer *timer = findTimer(event.handle);
+			if (!timer || timer->isPaused || timer->deadline != event.deadline)
+				continue; // cancelled, paused or rescheduled
+
+			TimerCallback callback = std::move(timer->callback);
+			bool isRecurring = timer->isRecurring;
+
+			if (isRecurring)
 			{
-				timer.duration.actual += dt.actual;
-
-				if (timer.duration.actual > timer.duration.target ||
-					Util::isEqual(timer.duration.actual, timer.duration.target))
-				{
-					timer.callback();
-
-					if (timer.isRecurring)
-						timer.duration.actual = 0.f;
-					else
-						timer.isActive = false;
-				}
-
+				timer->deadline = elapsed + timer->lifespan;
+				pushEvent(event.handle, timer->deadline);
 			}
+			else
+				freeTimer(event.handle);
+
+			lock.unlock();
+			callback();
+			lock.lock();
+
+			if (isRecurring)
+				if (Timer *recurring = findTimer(event.handle))
+					recurring->callback = std::move(callback);
+		}
+
+		// stale events pile up as timers are cancelled, rebuild the heap once they outnumber the live timers
+		if (events.size() > 2 * timers.size() + SMALL)
+		{
+			events.clear();
+			for (const Timer &timer : timers)
+				if (!timer.isPaused)
+					events.push_back({ timer.deadline, timer.handle });
+			std::make_heap(events.begin(), events.end(), std::greater<TimerEvent>());
+		}
 	}
 
 	void Time::free()
 	{
-
+		setFineSleep(false);
 	}
 
 	void Time::setFps(float _fps)
 	{
-		crashIf(_fps <= 0.f, "FPS must be more than 0.f");
+		crashIf(_fps < 0.f, "FPS can't be negative");
 
 		fps.target = _fps;
-		dt.target = 1.f / fps.target;
+		dt.target = fps.target ? 1.f / fps.target : 0.f;
+		setFineSleep(dt.target && pacingPolicy != PacingPolicy::SPIN);
 	}
 
 	TimeData Time::getFps()
@@ -82,17 +116,74 @@ namespace Snail
 
 	void Time::endDt()
 	{
-		prevProfileData = currProfileData;
 		dt.actual = getSeconds(rightNow - loopStart);
 
-		// calculate percentage usage of each system
-		for (auto &[label, data] : prevProfileData)
-			data.percent = data.actual / dt.actual;
+		// collect this frame's profile zones and calculate percentage usage of each
+		gs(Profiler)->endFrame(dt.actual);
 
 		// wait for target dt to be reached
 		if (dt.target)
-			while (dt.actual < dt.target)
-				dt.actual = getSeconds(rightNow - loopStart);
+		{
+			waitUntilTarget();
+			dt.actual = getSeconds(rightNow - loopStart);
+			pacingStats.addSample(dt.actual - dt.target);
+		}
+	}
+
+	void Time::waitUntilTarget()
+	{
+		switch (pacingPolicy)
+		{
+		case PacingPolicy::SPIN:
+			while (getSeconds(rightNow - loopStart) < dt.target);
+			break;
+
+		case PacingPolicy::SLEEP:
+			std::this_thread::sleep_until(loopStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<float>(dt.target)));
+			break;
+
+		case PacingPolicy::HYBRID:
+		{
+			// sleep in 1 ms steps while a late wake up can't overshoot the deadline, os timer resolution varies 
+			// so the overshoot is measured rather than assumed
+			const std::chrono::milliseconds step(1);
+
+			for (float remaining = dt.target - getSeconds(rightNow - loopStart);
+				remaining > spinThreshold + sleepOvershoot;
+				remaining = dt.target - getSeconds(rightNow - loopStart))
+			{
+				auto sleepStart = rightNow;
+				std::this_thread::sleep_for(step);
+				float overshoot = std::max(getSeconds(rightNow - sleepStart) - 0.001f, 0.f);
+				sleepOvershoot += (overshoot - sleepOvershoot) * 0.1f;
+			}
+
+			while (getSeconds(rightNow - loopStart) < dt.target)
+				std::this_thread::yield();
+			break;
+		}
+
+		default:
+			crashIf(true, "Invalid pacing policy " + toStr(static_cast<int>(pacingPolicy)));
+		}
+	}
+
+	void Time::setFineSleep(bool _isFineSleep)
+	{
+		if (isFineSleep == _isFineSleep)
+			return;
+		isFineSleep = _isFineSleep;
+
+		// windows wakes sleeping threads on a ~15.6 ms tick by default, far too coarse to pace with 1 ms sleeps
+#ifdef _WIN32
+		if (isFineSleep)
+			timeBeginPeriod(1);
+		else
+			timeEndPeriod(1);
+#endif
+
+		sleepOvershoot = 0.f; // measured at the old resolution
 	}
 
 	TimeData Time::getDt()
@@ -100,57 +191,293 @@ namespace Snail
 		return dt;
 	}
 
-	void Time::beginProfile()
+	void Time::setTickRate(float tickRate)
+	{
+		crashIf(tickRate <= 0.f, "Tick rate must be more than 0.f");
+
+		fixedDt = 1.f / tickRate;
+	}
+
+	float Time::getFixedDt()
+	{
+		return fixedDt;
+	}
+
+	void Time::setMaxTicks(unsigned _maxTicks)
+	{
+		crashIf(!_maxTicks, "Must allow at least 1 tick per frame");
+
+		maxTicks = _maxTicks;
+	}
+
+	unsigned Time::beginTicks()
+	{
+		accumulator += dt.actual;
+		unsigned ticks = static_cast<unsigned>(accumulator / fixedDt);
+
+		if (ticks > maxTicks)
+		{
+			// too far behind to catch up, drop the backlog rather than spiral
+			ticks = maxTicks;
+			accumulator = std::fmod(accumulator, fixedDt);
+		}
+		else
+			accumulator -= ticks * fixedDt;
+
+		alpha = accumulator / fixedDt;
+		return ticks;
+	}
+
+	float Time::getAlpha()
+	{
+		return alpha;
+	}
+
+	void Time::setPacingPolicy(PacingPolicy policy)
+	{
+		crashIf(policy >= PacingPolicy::MAX_PACING_POLICIES, "Invalid pacing policy");
+
+		pacingPolicy = policy;
+		setFineSleep(dt.target && pacingPolicy != PacingPolicy::SPIN);
+		resetPacingStats();
+	}
+
+	PacingPolicy Time::getPacingPolicy()
+	{
+		return pacingPolicy;
+	}
+
+	void Time::setSpinThreshold(float seconds)
+	{
+		crashIf(seconds < 0.f, "Spin threshold can't be negative");
+
+		spinThreshold = seconds;
+	}
+
+	const PacingStats &Time::getPacingStats()
 	{
-		profileStart = rightNow;
+		return pacingStats;
 	}
 
-	void Time::endProfile(const std::string &label)
+	void Time::resetPacingStats()
 	{
-		currProfileData[label] = ProfileData{ getSeconds(rightNow - profileStart) };
+		pacingStats = PacingStats();
 	}
 
-	const std::unordered_map<std::string, ProfileData> &Time::getProfileData()
+	void PacingStats::addSample(float overshoot)
 	{
-		return prevProfileData;
+		last = overshoot;
+		average += (overshoot - average) / static_cast<float>(++frameCount);
+		max = std::max(max, overshoot);
 	}
 
-	Timer::Timer(float lifespan, std::function<void()> _callback, std::optional<EntityId> _entityId,
-		bool _isRecurring)
-		: isActive(true), isRecurring(_isRecurring), duration{ 0.f, lifespan }, entityId(_entityId), 
-		callback(_callback)
+	std::string PacingStats::stringify() const
 	{
+		return "{ last: " + toStr(last) + "; average: " + toStr(average) + "; max: " + toStr(max) +
+			"; frameCount: " + toStr(frameCount) + " }";
+	}
 
+	bool TimerEvent::operator>(const TimerEvent &that) const
+	{
+		return deadline > that.deadline;
 	}
 
 	std::string Timer::stringify() const
 	{
 		std::ostringstream oss;
-		oss << std::boolalpha << "{ isActive: " << isActive << "; isRecurring: " << isRecurring << "; duration: "
-			<< duration << "; entityId: " << (entityId ? toStr(*entityId) : "-")
+		oss << std::boolalpha << "{ handle: " << handle << "; isRecurring: " << isRecurring << "; isPaused: " << isPaused << "; lifespan: "
+			<< lifespan << "; deadline: " << deadline << "; entityId: " << (entityId ? toStr(*entityId) : "-")
 			<< "; callback: " << Util::getFunctionSignature(callback) << " }";
 		return oss.str();
 	}
 
-	Timer *Time::addTimer(float lifespan, std::function<void()> callback, std::optional<EntityId> entityId, 
+	Timer *Time::findTimer(TimerHandle handle)
+	{
+		unsigned slot = getTimerSlot(handle);
+		if (slot >= slots.size() || slots[slot].version != getTimerVersion(handle))
+			return nullptr;
+
+		return &timers[slots[slot].denseIndex];
+	}
+
+	void Time::pushEvent(TimerHandle handle, double deadline)
+	{
+		events.push_back({ deadline, handle });
+		std::push_heap(events.begin(), events.end(), std::greater<TimerEvent>());
+	}
+
+	void Time::freeTimer(TimerHandle handle)
+	{
+		TimerSlot &slot = slots[getTimerSlot(handle)];
+		Timer &timer = timers[slot.denseIndex];
+
+		// unlink from the entity's list
+		if (timer.entityId)
+		{
+			if (timer.prevEntityTimer)
+				findTimer(timer.prevEntityTimer)->nextEntityTimer = timer.nextEntityTimer;
+			else
+				entityTimers[getEntityIndex(*timer.entityId)] = timer.nextEntityTimer;
+
+			if (timer.nextEntityTimer)
+				findTimer(timer.nextEntityTimer)->prevEntityTimer = timer.prevEntityTimer;
+		}
+
+		// swap pop out of the dense array too
+		if (slot.denseIndex != timers.size() - 1)
+		{
+			timer = std::move(timers.back());
+			slots[getTimerSlot(timer.handle)].denseIndex = slot.denseIndex;
+		}
+		timers.pop_back();
+
+		if (!++slot.version) // skip 0 so no handle ever equals INVALID_TIMER_HANDLE
+			slot.version = 1;
+		freeSlots.push_back(getTimerSlot(handle));
+	}
+
+	TimerHandle Time::addTimer(float lifespan, TimerCallback callback, std::optional<EntityId> entityId, 
 		bool isRecurring)
 	{
-		for (Timer &timer : timers)
-			if (!timer.isActive)
-			{
-				timer = Timer(lifespan, callback, entityId, isRecurring);
-				return &timer;
-			}
+		crashIf(lifespan < 0.f, "Timer lifespan can't be negative");
+		std::lock_guard<std::mutex> lock(mutex);
+
+		unsigned slot;
+		if (freeSlots.empty())
+		{
+			slot = static_cast<unsigned>(slots.size());
+			slots.emplace_back();
+		}
+		else
+		{
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+
+		slots[slot].denseIndex = static_cast<unsigned>(timers.size());
+		Timer &timer = timers.emplace_back();
+
+		timer.handle = makeTimerHandle(slot, slots[slot].version);
+		timer.isRecurring = isRecurring;
+		timer.lifespan = lifespan;
+		timer.deadline = elapsed + lifespan;
+		timer.entityId = entityId;
+		timer.callback = std::move(callback);
+
+		if (entityId)
+		{
+			TimerHandle &first = entityTimers[getEntityIndex(*entityId)];
+			timer.nextEntityTimer = first;
+			if (first)
+				findTimer(first)->prevEntityTimer = timer.handle;
+			first = timer.handle;
+		}
+
+		pushEvent(timer.handle, timer.deadline);
+		return timer.handle;
+	}
+
+	bool Time::cancelTimer(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
 
-		timers.emplace_back(lifespan, callback, entityId, isRecurring);
-		return &timers.back();
+		if (!findTimer(handle))
+			return false;
+
+		freeTimer(handle); // its event is skipped when popped
+		return true;
+	}
+
+	bool Time::pauseTimer(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		Timer *timer = findTimer(handle);
+		if (!timer)
+			return false;
+
+		if (!timer->isPaused)
+		{
+			timer->isPaused = true;
+			timer->remaining = std::max(timer->deadline - elapsed, 0.0);
+		}
+		return true;
+	}
+
+	bool Time::resumeTimer(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		Timer *timer = findTimer(handle);
+		if (!timer)
+			return false;
+
+		if (timer->isPaused)
+		{
+			timer->isPaused = false;
+			timer->deadline = elapsed + timer->remaining;
+			pushEvent(handle, timer->deadline);
+		}
+		return true;
+	}
+
+	bool Time::rescheduleTimer(TimerHandle handle, float lifespan)
+	{
+		crashIf(lifespan < 0.f, "Timer lifespan can't be negative");
+		std::lock_guard<std::mutex> lock(mutex);
+
+		Timer *timer = findTimer(handle);
+		if (!timer)
+			return false;
+
+		timer->lifespan = lifespan;
+		if (timer->isPaused)
+			timer->remaining = lifespan;
+		else
+		{
+			timer->deadline = elapsed + lifespan;
+			pushEvent(handle, timer->deadline); // the old event no longer matches the deadline
+		}
+		return true;
+	}
+
+	bool Time::isTimerActive(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return findTimer(handle);
+	}
+
+	bool Time::isTimerPaused(TimerHandle handle)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		Timer *timer = findTimer(handle);
+		return timer && timer->isPaused;
 	}
 
 	void Time::stopTimer(EntityId id)
 	{
-		for (Timer &timer : timers)
-			if (timer.entityId && *timer.entityId == id)
-				timer.isActive = false;
+		std::lock_guard<std::mutex> lock(mutex);
+
+		const TimerHandle *first = entityTimers.find(getEntityIndex(id));
+		if (!first)
+			return;
+
+		// the list is per entity index, so timers of an older generation are left alone
+		for (TimerHandle handle = *first; handle; )
+		{
+			Timer *timer = findTimer(handle);
+			handle = timer->nextEntityTimer;
+
+			if (*timer->entityId == id)
+				freeTimer(timer->handle);
+		}
+	}
+
+	void Time::stopTimers(const std::vector<EntityId> &ids)
+	{
+		for (EntityId id : ids)
+			stopTimer(id);
 	}
 
 }
\ No newline at end of file
@@ -3,11 +3,15 @@
 #include "System.h"
 #include "Utility.h"
 #include "Types.h"
+#include "InplaceFunction.h"
+#include "PagedArray.h"
 
 #include <unordered_map>
 #include <chrono>
 #include <optional>
 #include <functional>
+#include <thread>
+#include <mutex>
 
 namespace Snail
 {
@@ -22,41 +26,88 @@ namespace Snail
 		std::string stringify() const override;
 	};
 
-	struct ProfileData : public Debugger::Printable
+	// how far past the target dt frames end, in seconds
+	struct PacingStats : public Debugger::Printable
 	{
-		float actual;
-		float percent;
+		float last = 0.f;
+		float average = 0.f;
+		float max = 0.f;
+		size_t frameCount = 0;
 
-		ProfileData(float _actual = 0.f, float target = 0.f);
+		void addSample(float overshoot);
 
 		std::string stringify() const override;
 	};
 
+	// captures must fit in the buffer, bigger state should be captured by pointer
+	using TimerCallback = InplaceFunction<void(), 48>;
+
 	struct Timer : public Debugger::Printable
 	{
-		bool isActive;
-		bool isRecurring;
-		TimeData duration;
+		TimerHandle handle = INVALID_TIMER_HANDLE;
+		bool isRecurring = false;
+		bool isPaused = false;
+		float lifespan = 0.f;
+		double deadline = 0.0; // in seconds of Time::elapsed
+		double remaining = 0.0; // time left when paused
 		std::optional<EntityId> entityId;
-		std::function<void()> callback;
-
-		Timer(float lifespan, std::function<void()> _callback, std::optional<EntityId> _entityId = std::nullopt,
-			bool _isRecurring = false);
+		TimerHandle prevEntityTimer = INVALID_TIMER_HANDLE; // neighbours in its entity's timer list
+		TimerHandle nextEntityTimer = INVALID_TIMER_HANDLE;
+		TimerCallback callback;
 
 		std::string stringify() const override;
 	};
 
+	// maps a handle to the timer's place in the dense timer array
+	struct TimerSlot
+	{
+		unsigned version = 1;
+		unsigned denseIndex = 0;
+	};
+
+	// due timers are popped off a min heap, cancelled, paused or rescheduled timers leave their old entries behind 
+	// and those are skipped when they no longer match the timer
+	struct TimerEvent
+	{
+		double deadline;
+		TimerHandle handle;
+
+		bool operator>(const TimerEvent &that) const;
+	};
+
 	class Time : public System
 	{
 		TimeData fps;
 		TimeData dt{ 1.f / 60.f };
 
-		std::unordered_map<std::string, ProfileData> prevProfileData; // one frame before
-		std::unordered_map<std::string, ProfileData> currProfileData; // current frame
 		std::chrono::steady_clock::time_point loopStart;
-		std::chrono::steady_clock::time_point profileStart;
 
-		std::vector<Timer> timers;
+		float fixedDt = 1.f / 60.f;
+		float accumulator = 0.f; // time not simulated yet
+		unsigned maxTicks = 5;
+		float alpha = 0.f;
+
+		PacingPolicy pacingPolicy = PacingPolicy::HYBRID;
+		float spinThreshold = 0.001f;
+		float sleepOvershoot = 0.f; // running estimate of how late a 1 ms sleep wakes up
+		bool isFineSleep = false; // whether the os timer resolution is raised to 1 ms for pacing
+		PacingStats pacingStats;
+
+		void waitUntilTarget();
+		void setFineSleep(bool _isFineSleep); // raises the os timer resolution while sleeps are used for pacing
+
+		std::mutex mutex; // timers can be added from jobs running on workers
+		double elapsed = 0.0;
+		std::vector<Timer> timers; // live timers only, packed so they can be walked without gaps
+		std::vector<TimerSlot> slots;
+		std::vector<unsigned> freeSlots;
+		std::vector<TimerEvent> events;
+		std::vector<TimerEvent> dueEvents;
+		PagedArray<TimerHandle> entityTimers; // first timer tied to each entity index, pages are kept once used
+
+		Timer *findTimer(TimerHandle handle);
+		void pushEvent(TimerHandle handle, double deadline);
+		void freeTimer(TimerHandle handle);
 
 	public:
 
@@ -64,20 +115,42 @@ namespace Snail
 		void update() override;
 		void free() override;
 
-		void setFps(float _fps);
+		void setFps(float _fps); // 0 leaves the frame rate uncapped
 		TimeData getFps();
 		
 		void beginDt();
 		void endDt();
 		TimeData getDt();
 
-		void beginProfile();
-		void endProfile(const std::string &label);
-		const std::unordered_map<std::string, ProfileData> &getProfileData();
-
-		Timer *addTimer(float lifespan, std::function<void()> callback,
+		// fixed step systems run at this rate no matter how often frames are drawn
+		void setTickRate(float tickRate);
+		float getFixedDt();
+		// caps how many steps a slow frame can catch up on, time past that is dropped
+		void setMaxTicks(unsigned _maxTicks);
+		unsigned beginTicks(); // banks the last frame's dt and returns how many fixed steps to run this frame
+		float getAlpha(); // how far this frame is between the last two fixed steps, for interpolation
+
+		void setPacingPolicy(PacingPolicy policy);
+		PacingPolicy getPacingPolicy();
+		// hybrid pacing stops sleeping once this many seconds are left in the frame
+		void setSpinThreshold(float seconds);
+		const PacingStats &getPacingStats();
+		void resetPacingStats();
+
+		// callbacks are called on the main thread while no other system runs, record structural changes in the
+		// command buffer
+		// timers tied to an entity are stopped when it is removed
+		// handles stay valid until the timer finishes or is cancelled, the functions taking one return false after
+		TimerHandle addTimer(float lifespan, TimerCallback callback,
 			std::optional<EntityId> entityId = std::nullopt, bool isRecurring = false);
-		void stopTimer(EntityId id);
+		bool cancelTimer(TimerHandle handle);
+		bool pauseTimer(TimerHandle handle);
+		bool resumeTimer(TimerHandle handle);
+		bool rescheduleTimer(TimerHandle handle, float lifespan); // restarts the timer with a new lifespan
+		bool isTimerActive(TimerHandle handle);
+		bool isTimerPaused(TimerHandle handle);
+		void stopTimer(EntityId id); // cancels every timer tied to the entity
+		void stopTimers(const std::vector<EntityId> &ids);
 	};
 
 }
\ No newline at end of file
@@ -7,6 +7,75 @@
 namespace Snail
 {
 
+	Signature &Signature::set(CompId id)
+	{
+		crashIf(id >= MAX_COMPONENTS, "Component id " + toStr(id) + " does not fit in a signature");
+		words[id / WORD_BITS] |= uint64_t(1) << id % WORD_BITS;
+		return *this;
+	}
+
+	Signature &Signature::reset(CompId id)
+	{
+		crashIf(id >= MAX_COMPONENTS, "Component id " + toStr(id) + " does not fit in a signature");
+		words[id / WORD_BITS] &= ~(uint64_t(1) << id % WORD_BITS);
+		return *this;
+	}
+
+	bool Signature::test(CompId id) const
+	{
+		return id < MAX_COMPONENTS && words[id / WORD_BITS] >> id % WORD_BITS & 1;
+	}
+
+	bool Signature::any() const
+	{
+		uint64_t combined = 0;
+		for (uint64_t word : words)
+			combined |= word;
+		return combined;
+	}
+
+	bool Signature::contains(const Signature &that) const
+	{
+		uint64_t missing = 0;
+		for (size_t i = 0; i < words.size(); ++i)
+			missing |= that.words[i] & ~words[i];
+		return !missing;
+	}
+
+	bool Signature::intersects(const Signature &that) const
+	{
+		uint64_t common = 0;
+		for (size_t i = 0; i < words.size(); ++i)
+			common |= that.words[i] & words[i];
+		return common;
+	}
+
+	Signature Signature::operator&(const Signature &that) const
+	{
+		Signature ret;
+		for (size_t i = 0; i < words.size(); ++i)
+			ret.words[i] = words[i] & that.words[i];
+		return ret;
+	}
+
+	Signature Signature::operator|(const Signature &that) const
+	{
+		Signature ret;
+		for (size_t i = 0; i < words.size(); ++i)
+			ret.words[i] = words[i] | that.words[i];
+		return ret;
+	}
+
+	bool Signature::operator==(const Signature &that) const
+	{
+		return words == that.words;
+	}
+
+	bool Signature::operator!=(const Signature &that) const
+	{
+		return words != that.words;
+	}
+
 	Color::Color(float _r, float _g, float _b, float _a)
 		: r(_r), g(_g), b(_b), a(_a)
 	{
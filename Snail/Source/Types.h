@@ -2,7 +2,7 @@
 
 #include "Utility.h"
 
-#include <bitset>
+#include <cstdint>
 #include <optional>
 #include <array>
 
@@ -12,7 +12,96 @@ namespace Snail
 
 	using EntityId = unsigned;
 	using CompId = unsigned;
-	using Signature = std::bitset<MAX_COMPONENTS>;
+	constexpr CompId INVALID_COMP_ID = static_cast<CompId>(-1);
+
+	// one bit per component type, stored as a few 64 bit words so matching is a handful of word-wise ANDs
+	class Signature
+	{
+		static constexpr unsigned WORD_BITS = 64;
+		std::array<uint64_t, (MAX_COMPONENTS + WORD_BITS - 1) / WORD_BITS> words{};
+
+	public:
+
+		Signature &set(CompId id);
+		Signature &reset(CompId id);
+		bool test(CompId id) const;
+		bool any() const;
+
+		bool contains(const Signature &that) const; // whether every bit in that is also in this
+		bool intersects(const Signature &that) const; // whether any bit in that is also in this
+
+		Signature operator&(const Signature &that) const;
+		Signature operator|(const Signature &that) const;
+		bool operator==(const Signature &that) const;
+		bool operator!=(const Signature &that) const;
+
+		// calls func(CompId) for each set bit only, skipping empty words entirely
+		template <typename Func>
+		void forEach(Func func) const
+		{
+			for (unsigned i = 0; i < static_cast<unsigned>(words.size()); ++i)
+				for (uint64_t word = words[i]; word; word &= word - 1)
+					func(i * WORD_BITS + Util::countTrailingZeros(word));
+		}
+	};
+
+	// an entity id packs an index into the entity arrays with the generation of that index
+	// the generation is bumped every time the entity at that index is removed, so stale ids can be detected
+	constexpr unsigned ENTITY_INDEX_BITS = 20;
+	constexpr unsigned ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1u;
+	constexpr unsigned ENTITY_GENERATION_MASK = ~0u >> ENTITY_INDEX_BITS;
+
+	static_assert(MAX_ENTITIES <= ENTITY_INDEX_MASK + 1u, "Entity index bits cannot hold MAX_ENTITIES");
+
+	inline unsigned getEntityIndex(EntityId id)
+	{
+		return id & ENTITY_INDEX_MASK;
+	}
+
+	inline unsigned getEntityGeneration(EntityId id)
+	{
+		return id >> ENTITY_INDEX_BITS;
+	}
+
+	inline EntityId makeEntityId(unsigned index, unsigned generation)
+	{
+		return (generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS | index;
+	}
+
+	/*! ------------ Profiling ------------ */
+
+	using LabelId = unsigned;
+
+	/*! ------------ Time ------------ */
+
+	// a timer handle packs a slot in Time's slot map with the version of that slot, the version is bumped every 
+	// time the timer in that slot finishes or is cancelled so stale handles can be detected
+	using TimerHandle = uint64_t;
+	constexpr TimerHandle INVALID_TIMER_HANDLE = 0; // versions start at 1 so no timer ever gets this handle
+
+	inline unsigned getTimerSlot(TimerHandle handle)
+	{
+		return static_cast<unsigned>(handle);
+	}
+
+	inline unsigned getTimerVersion(TimerHandle handle)
+	{
+		return static_cast<unsigned>(handle >> 32);
+	}
+
+	inline TimerHandle makeTimerHandle(unsigned slot, unsigned version)
+	{
+		return static_cast<TimerHandle>(version) << 32 | slot;
+	}
+
+	// how Time::endDt waits out the rest of a frame
+	enum class PacingPolicy
+	{
+		SPIN, // most accurate, burns a core
+		SLEEP, // cheapest, at the mercy of the os scheduler
+		HYBRID, // sleeps until close to the deadline then yields for the rest
+		MAX_PACING_POLICIES
+	};
 
 	/*! ------------ Graphics ------------ */
 
@@ -39,6 +128,13 @@ namespace Snail
 		MAX_EDGE_TYPES
 	};
 
+	enum class TriangulationMode
+	{
+		EAR_CLIPPING, // fastest
+		CONSTRAINED_DELAUNAY, // avoids slivers, maximises the smallest angle
+		MAX_TRIANGULATION_MODES
+	};
+
 	struct Window
 	{
 		Vec2 size;
@@ -80,7 +176,6 @@ namespace Snail
 		unsigned p1, p2;
 		EdgeType type = EdgeType::NONE;
 		bool isOutside; // whether is inside or outside the shape
-		bool shldIgnore = false; // only for 1 function, whether raycast should ignore this because it collides at the vertex
 
 		explicit Edge(unsigned _p1, unsigned _p2, EdgeType _type = EdgeType::NONE, bool _isOutside = true);
 
@@ -10,6 +10,11 @@
 #include <sstream>
 #include <iostream>
 #include <unordered_map>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 /*! ------------ Macros ------------ */
 
@@ -35,8 +40,8 @@ constexpr unsigned LONG_LEN = 32;
 constexpr unsigned SMALL = 64;
 constexpr unsigned MEDIUM = 256;
 constexpr unsigned BIG = 1024;
-constexpr unsigned MAX_ENTITIES = 2048;
-constexpr unsigned MAX_COMPONENTS = 2; // change if components are added/removed
+constexpr unsigned MAX_ENTITIES = 1u << 20; // upper bound only, entity storage grows with usage
+constexpr unsigned MAX_COMPONENTS = 128; // number of bits in a signature (keep to a multiple of 64)
 
 // math
 constexpr float EPSILON = 0.000001f;
@@ -98,6 +103,18 @@ namespace Snail
 			return (flt1 - flt2 > 0.f ? flt1 - flt2 : flt2 - flt1) <= EPSILON;
 		}
 
+		// index of the lowest set bit, val must not be 0
+		inline unsigned countTrailingZeros(uint64_t val)
+		{
+#ifdef _MSC_VER
+			unsigned long index;
+			_BitScanForward64(&index, val);
+			return static_cast<unsigned>(index);
+#else
+			return static_cast<unsigned>(__builtin_ctzll(val));
+#endif
+		}
+
 		template <typename T>
 		T normalize(T val)
 		{
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ComponentArray.h"
+
+#include <tuple>
+#include <vector>
+
+namespace Snail
+{
+
+	// all entities that have every component in Ts, get one from ComponentManager::getView
+	// the entity list is kept up to date by EntityManager::setSignature so iterating never has to filter
+	template <typename... Ts>
+	class View
+	{
+		const std::vector<EntityId> &entityIds;
+		std::tuple<ComponentArray<Ts> *...> compArrays;
+
+	public:
+
+		View(const std::vector<EntityId> &_entityIds, ComponentArray<Ts> *..._compArrays)
+			: entityIds(_entityIds), compArrays(_compArrays...)
+		{
+
+		}
+
+		// entities must not be added or removed and components must not be added to or removed from 
+		// entities in this view while iterating through it
+		std::vector<EntityId>::const_iterator begin() const
+		{
+			return entityIds.begin();
+		}
+
+		std::vector<EntityId>::const_iterator end() const
+		{
+			return entityIds.end();
+		}
+
+		size_t size() const
+		{
+			return entityIds.size();
+		}
+
+		EntityId operator[](size_t i) const
+		{
+			return entityIds[i];
+		}
+
+		template <typename T>
+		T &get(EntityId id)
+		{
+			return std::get<ComponentArray<T> *>(compArrays)->getData(id);
+		}
+
+		// func should take (EntityId, Ts &...)
+		template <typename Func>
+		void each(Func func)
+		{
+			for (EntityId id : entityIds)
+				func(id, get<Ts>(id)...);
+		}
+
+		// same as above but only for entities in [first, last)
+		template <typename Func>
+		void each(Func func, size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; ++i)
+				func(entityIds[i], get<Ts>(entityIds[i])...);
+		}
+	};
+
+}
\ No newline at end of file
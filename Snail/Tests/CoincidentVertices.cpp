@@ -0,0 +1,113 @@
+#include "Tests.h"
+#include "Geometry.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace Snail;
+
+	double getArea(const std::vector<Vertex> &vertices, const std::vector<Triangle> &triangles)
+	{
+		double area = 0.0;
+		for (const Triangle &triangle : triangles)
+			area += std::abs(Geometry::orient(vertices[triangle.p1].pos, vertices[triangle.p2].pos,
+				vertices[triangle.p3].pos)) / 2.0;
+		return area;
+	}
+
+	// how many triangles have the point strictly inside, more than 1 means they overlap
+	unsigned getCoverCount(const std::vector<Vertex> &vertices, const std::vector<Triangle> &triangles, double x,
+		double y)
+	{
+		auto orient = [x, y](Vec2 a, Vec2 b) {
+			return (static_cast<double>(b.x) - a.x) * (y - a.y) - (static_cast<double>(b.y) - a.y) * (x - a.x); };
+
+		unsigned count = 0;
+		for (const Triangle &triangle : triangles)
+		{
+			Vec2 a = vertices[triangle.p1].pos, b = vertices[triangle.p2].pos, c = vertices[triangle.p3].pos;
+			double d1 = orient(a, b), d2 = orient(b, c), d3 = orient(c, a);
+			if ((d1 > 0.0 && d2 > 0.0 && d3 > 0.0) || (d1 < 0.0 && d2 < 0.0 && d3 < 0.0))
+				++count;
+		}
+		return count;
+	}
+
+	// whether both modes fill the same area without any triangles overlapping, checked at sample points
+	bool ifIsFilledAlike(const std::vector<Vertex> &vertices, const std::vector<Edge> &edges, std::mt19937 &rng,
+		double size)
+	{
+		constexpr unsigned SAMPLES = 200;
+
+		std::vector<Triangle> earClipped = Geometry::triangulate(vertices, edges);
+		std::vector<Triangle> delaunay = Geometry::triangulate(vertices, edges,
+			TriangulationMode::CONSTRAINED_DELAUNAY);
+		if (std::abs(getArea(vertices, earClipped) - getArea(vertices, delaunay)) > 0.001)
+			return false;
+
+		std::uniform_real_distribution<double> coord(0.0, size);
+		for (unsigned i = 0; i < SAMPLES; ++i)
+		{
+			double x = coord(rng), y = coord(rng);
+			unsigned earClippedCount = getCoverCount(vertices, earClipped, x, y);
+			if (earClippedCount > 1 || earClippedCount != getCoverCount(vertices, delaunay, x, y))
+				return false;
+		}
+		return true;
+	}
+}
+
+// shapes whose vertices share positions without sharing indices, as split and pruned by ShapeComponent::update
+bool testCoincidentVertices()
+{
+	constexpr unsigned GRAPHS = 3000, GRID_SIZE = 8;
+
+	std::mt19937 rng(5);
+	unsigned failures = 0;
+
+	// a square with a triangle cut out of its bottom edge, drawn as 2 loops that don't share vertices
+	{
+		std::vector<Vertex> vertices = { Vertex({ 0.f, 0.f }), Vertex({ 4.f, 0.f }), Vertex({ 4.f, 4.f }),
+			Vertex({ 0.f, 4.f }), Vertex({ 0.f, 0.f }), Vertex({ 4.f, 0.f }), Vertex({ 2.f, 2.f }) };
+		std::vector<Edge> edges = { Edge(0, 1), Edge(1, 2), Edge(2, 3), Edge(3, 0), Edge(4, 5), Edge(5, 6),
+			Edge(6, 4) };
+
+		if (std::abs(getArea(vertices, Geometry::triangulate(vertices, edges)) - 12.0) > 0.001 ||
+			!ifIsFilledAlike(vertices, edges, rng, 4.0))
+		{
+			std::printf("Square with a notch: filled wrong\n");
+			++failures;
+		}
+	}
+
+	// a few closed loops snapped to a small grid, so corners and whole edges keep landing on each other
+	for (unsigned graph = 0; graph < GRAPHS; ++graph)
+	{
+		std::vector<Vertex> vertices;
+		std::vector<Edge> edges;
+
+		for (unsigned loops = 1 + rng() % 4; loops; --loops)
+		{
+			unsigned first = static_cast<unsigned>(vertices.size()), count = 3 + rng() % 4;
+			for (unsigned i = 0; i < count; ++i)
+			{
+				float x = static_cast<float>(rng() % GRID_SIZE), y = static_cast<float>(rng() % GRID_SIZE);
+				vertices.emplace_back(Vec2(x, y));
+				edges.emplace_back(first + i, first + (i + 1) % count);
+			}
+		}
+
+		Geometry::splitCrossings(vertices, edges);
+		Geometry::pruneDangling(vertices, edges);
+
+		if (!ifIsFilledAlike(vertices, edges, rng, GRID_SIZE) && ++failures <= 5)
+			std::printf("Graph %u: ear clipping and delaunay fill different areas or overlap\n", graph);
+	}
+
+	std::printf("CoincidentVertices: %u / %u shapes filled alike\n", GRAPHS + 1 - failures, GRAPHS + 1);
+	return !failures;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "Tests.h"
+#include "Debug.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace Snail
+{
+	namespace Debugger
+	{
+		// the engine's logger needs the whole core, a failed crashIf only has to fail the tests here
+		void log(int, const std::string &reason, const std::string &fileName, int line)
+		{
+			std::printf("%s (%s:%d)\n", reason.c_str(), fileName.c_str(), line);
+			std::exit(EXIT_FAILURE);
+		}
+	}
+}
+
+int main()
+{
+	bool isPassing = true;
+	isPassing = testPruneDangling() && isPassing;
+	isPassing = testCoincidentVertices() && isPassing;
+
+	return isPassing ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
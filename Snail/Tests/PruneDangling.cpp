@@ -0,0 +1,96 @@
+#include "Tests.h"
+#include "Geometry.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace Snail;
+
+	// the loop ShapeComponent::update used before Geometry::pruneDangling, kept as the reference it has to match
+	void pruneDanglingReference(std::vector<Vertex> &vertices, std::vector<Edge> &edges)
+	{
+		bool didVertexGetRemoved = true;
+
+		// repeat until no more needs to be removed
+		while (didVertexGetRemoved)
+		{
+			didVertexGetRemoved = false;
+
+			for (unsigned i = 0; i < static_cast<unsigned>(vertices.size()); ++i)
+			{
+				if (vertices[i].type == VertexType::REMOVED)
+					continue;
+
+				int count = 0;
+				std::vector<Edge *> edgesWithCurrVertex;
+
+				for (Edge &edge : edges)
+					if (edge.type != EdgeType::REMOVED && (edge.p1 == i || edge.p2 == i))
+					{
+						++count;
+						edgesWithCurrVertex.push_back(&edge);
+					}
+
+				if (count < 2)
+				{
+					vertices[i].type = VertexType::REMOVED;
+					std::for_each(edgesWithCurrVertex.begin(), edgesWithCurrVertex.end(),
+						[](auto &elem) { elem->type = EdgeType::REMOVED; });
+					didVertexGetRemoved = true;
+					break; // next loop will check the rest
+				}
+			}
+		}
+	}
+}
+
+// random graphs with self loops, duplicate edges and already removed vertices and edges, every 4th one also gets a
+// cycle through all its vertices so there's something left after pruning
+bool testPruneDangling()
+{
+	constexpr unsigned GRAPHS = 20000, MAX_VERTICES = 30;
+
+	std::mt19937 rng(7);
+	unsigned mismatches = 0;
+
+	for (unsigned graph = 0; graph < GRAPHS; ++graph)
+	{
+		unsigned vertexCount = 1 + rng() % MAX_VERTICES, edgeCount = rng() % (2 * vertexCount + 3);
+
+		std::vector<Vertex> vertices(vertexCount);
+		for (Vertex &vertex : vertices)
+			if (rng() % 10 == 0)
+				vertex.type = VertexType::REMOVED;
+
+		std::vector<Edge> edges;
+		for (unsigned i = 0; i < edgeCount; ++i)
+		{
+			unsigned p1 = rng() % vertexCount, p2 = rng() % 5 == 0 ? p1 : rng() % vertexCount;
+			edges.emplace_back(p1, p2, rng() % 8 == 0 ? EdgeType::REMOVED : EdgeType::NONE);
+		}
+		if (graph % 4 == 0)
+			for (unsigned i = 0; i < vertexCount; ++i)
+				edges.emplace_back(i, (i + 1) % vertexCount);
+
+		std::vector<Vertex> expectedVertices = vertices;
+		std::vector<Edge> expectedEdges = edges;
+		pruneDanglingReference(expectedVertices, expectedEdges);
+		Geometry::pruneDangling(vertices, edges);
+
+		bool isMatch = true;
+		for (unsigned i = 0; i < vertexCount; ++i)
+			isMatch = isMatch && vertices[i].type == expectedVertices[i].type;
+		for (unsigned i = 0; i < static_cast<unsigned>(edges.size()); ++i)
+			isMatch = isMatch && edges[i].type == expectedEdges[i].type;
+
+		if (!isMatch && ++mismatches <= 5)
+			std::printf("Graph %u: pruned vertices or edges differ from the reference\n", graph);
+	}
+
+	std::printf("PruneDangling: %u / %u graphs match the reference\n", GRAPHS - mismatches, GRAPHS);
+	return !mismatches;
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+// each test prints a summary and returns whether it passed
+bool testPruneDangling();
+bool testCoincidentVertices();
\ No newline at end of file